@@ -0,0 +1,127 @@
+
+# include <chrono>
+# include <memory>
+# include <thread>
+# include <vector>
+# include <iostream>
+# include "EventsPool.hh"
+
+namespace {
+
+  using sdl::core::EventsPool;
+
+  /**
+   * @brief - Mimics a paint event: a polymorphic object with an area and a
+   *          few pointers.
+   */
+  class Dummy {
+    public:
+
+      explicit
+      Dummy(float value):
+        m_area{value, value, value, value},
+        m_emitter(nullptr),
+        m_receiver(nullptr)
+      {}
+
+      virtual ~Dummy() = default;
+
+      float
+      getValue() const noexcept {
+        return m_area[0];
+      }
+
+    private:
+
+      float m_area[4];
+      void* m_emitter;
+      void* m_receiver;
+  };
+
+  /**
+   * @brief - Number of events alive at once and number of rounds of creation
+   *          and release performed by each thread.
+   */
+  constexpr unsigned Batch = 16u;
+  constexpr unsigned Rounds = 200000u;
+
+  /**
+   * @brief - Creates and releases batches of events with the input factory,
+   *          similarly to the events posted and processed in a frame.
+   */
+  template <typename Factory>
+  float
+  run(Factory factory) {
+    std::vector<std::shared_ptr<Dummy>> events;
+    events.reserve(Batch);
+
+    float sum = 0.0f;
+
+    for (unsigned round = 0u ; round < Rounds ; ++round) {
+      for (unsigned id = 0u ; id < Batch ; ++id) {
+        events.push_back(factory(static_cast<float>(id)));
+      }
+
+      for (std::vector<std::shared_ptr<Dummy>>::const_iterator e = events.cbegin() ; e != events.cend() ; ++e) {
+        sum += (*e)->getValue();
+      }
+
+      events.clear();
+    }
+
+    return sum;
+  }
+
+  /**
+   * @brief - Runs the benchmark on the input number of threads and returns the
+   *          average time to create and release an event in nanoseconds, over
+   *          all the threads.
+   */
+  template <typename Factory>
+  double
+  measure(unsigned threads,
+          Factory factory)
+  {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned id = 0u ; id < threads ; ++id) {
+      workers.emplace_back(
+        [&factory]() {
+          volatile float sink = run(factory);
+          (void)sink;
+        }
+      );
+    }
+
+    for (std::vector<std::thread>::iterator worker = workers.begin() ; worker != workers.end() ; ++worker) {
+      worker->join();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / (static_cast<double>(Rounds) * Batch * threads);
+  }
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/) {
+  const auto shared = [](float value) {
+    return std::make_shared<Dummy>(value);
+  };
+  const auto pooled = [](float value) {
+    return EventsPool::create<Dummy>(value);
+  };
+
+  for (unsigned threads = 1u ; threads <= 4u ; threads *= 2u) {
+    const double reference = measure(threads, shared);
+    const double pool = measure(threads, pooled);
+
+    std::cout << "[BENCH] " << threads << " thread(s): make_shared " << reference << " ns/event, pool " << pool << " ns/event" << std::endl;
+  }
+
+  std::cout << "[BENCH] Live: " << EventsPool::getLiveCount() << ", peak: " << EventsPool::getPeakCount() << std::endl;
+
+  return 0;
+}
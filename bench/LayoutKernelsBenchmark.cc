@@ -0,0 +1,140 @@
+
+# include <chrono>
+# include <random>
+# include <vector>
+# include <iostream>
+# include "LayoutKernels.hh"
+
+namespace {
+
+  using namespace sdl::core::layout;
+
+  /**
+   * @brief - Mimics the `Layout::WidgetInfo` structure used by the per item path:
+   *          the constraints are queried from the policy for each item.
+   */
+  struct Item {
+    bool fixed;
+    bool shrink;
+    bool extend;
+    float min;
+    float hint;
+    float max;
+    bool hintValid;
+    float current;
+  };
+
+  /**
+   * @brief - Number of times each pass is run for a given number of items.
+   */
+  constexpr unsigned Rounds = 2000u;
+
+  std::vector<Item>
+  generate(unsigned count) {
+    std::mt19937 rng(42u);
+    std::uniform_real_distribution<float> size(0.0f, 200.0f);
+
+    std::vector<Item> items(count);
+    for (std::vector<Item>::iterator it = items.begin() ; it != items.end() ; ++it) {
+      it->fixed = (rng() % 8u) == 0u;
+      it->shrink = (rng() % 2u) == 0u;
+      it->extend = (rng() % 2u) == 0u;
+      it->min = size(rng) * 0.5f;
+      it->max = it->min + size(rng);
+      it->hint = it->min + (it->max - it->min) * 0.5f;
+      it->hintValid = (rng() % 4u) != 0u;
+      it->current = size(rng);
+    }
+
+    return items;
+  }
+
+  AxisInfo
+  toArrays(const std::vector<Item>& items) {
+    AxisInfo axis;
+
+    for (std::vector<Item>::const_iterator it = items.cbegin() ; it != items.cend() ; ++it) {
+      axis.current.push_back(it->current);
+      axis.min.push_back(it->min);
+      axis.hint.push_back(it->hint);
+      axis.max.push_back(it->max);
+      axis.flags.push_back(toConstraints(it->hintValid, it->fixed, it->shrink, it->extend));
+    }
+
+    return axis;
+  }
+
+  /**
+   * @brief - Runs the input pass `Rounds` times and returns the average time to
+   *          process a single item in nanoseconds.
+   */
+  template <typename Pass>
+  double
+  measure(unsigned count,
+          Pass pass)
+  {
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    float sum = 0.0f;
+    for (unsigned round = 0u ; round < Rounds ; ++round) {
+      sum += pass();
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    volatile float sink = sum;
+    (void)sink;
+
+    return elapsed.count() / (static_cast<double>(Rounds) * count);
+  }
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/) {
+  std::cout << "[BENCH] Kernels: " << getKernelsName() << std::endl;
+
+  for (unsigned count = 16u ; count <= 16384u ; count *= 8u) {
+    const std::vector<Item> items = generate(count);
+    const AxisInfo axis = toArrays(items);
+
+    const std::vector<float> deltas(count, 12.5f);
+    std::vector<float> out(count);
+    std::vector<std::uint8_t> usable(count);
+
+    // The per item path builds the constraints of each item from its policy
+    // before clamping it, like `Layout::computeWidthFromPolicy` does.
+    const auto perItemClamp = [&]() {
+      for (unsigned id = 0u ; id < count ; ++id) {
+        const Item& i = items[id];
+        out[id] = clamp(i.current, deltas[id], i.min, i.hint, i.max, toConstraints(i.hintValid, i.fixed, i.shrink, i.extend));
+      }
+      return out[count / 2u];
+    };
+    const auto arraysClamp = [&]() {
+      clampAxis(axis, deltas.data(), out.data());
+      return out[count / 2u];
+    };
+
+    const auto perItemUsable = [&]() {
+      for (unsigned id = 0u ; id < count ; ++id) {
+        const Item& i = items[id];
+        usable[id] = isUsable(i.current, i.min, i.hint, i.max, toConstraints(i.hintValid, i.fixed, i.shrink, i.extend), Constraint::Shrink);
+      }
+      return static_cast<float>(usable[count / 2u]);
+    };
+    const auto arraysUsable = [&]() {
+      usableAxis(axis, Constraint::Shrink, usable.data());
+      return static_cast<float>(usable[count / 2u]);
+    };
+
+    std::cout << "[BENCH] " << count << " item(s): "
+              << "clamp per item " << measure(count, perItemClamp) << " ns/item, "
+              << "arrays " << measure(count, arraysClamp) << " ns/item; "
+              << "usable per item " << measure(count, perItemUsable) << " ns/item, "
+              << "arrays " << measure(count, arraysUsable) << " ns/item"
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,177 @@
+
+# include "EventsPool.hh"
+# include <array>
+# include <atomic>
+# include <vector>
+# include <algorithm>
+
+namespace sdl {
+  namespace core {
+
+    namespace {
+
+      /**
+       * @brief - Blocks are grouped by size classes with a granularity of `Granularity`
+       *          bytes. Blocks larger than the last class are not pooled.
+       */
+      constexpr std::size_t Granularity = 32u;
+      constexpr std::size_t ClassesCount = 16u;
+
+      /**
+       * @brief - The statistics and settings shared by all the threads. The counters are
+       *          only used for reporting so they don't need any ordering.
+       */
+      std::atomic<unsigned> live(0u);
+      std::atomic<unsigned> peak(0u);
+      std::atomic<unsigned> capacity(256u);
+
+      /**
+       * @brief - Whether the cache of the calling thread has been destroyed: events
+       *          released by thread local objects destroyed after it bypass the pool.
+       */
+      thread_local bool destroyed = false;
+
+      /**
+       * @brief - The free blocks of each size class kept by a thread. The blocks are
+       *          returned to the heap when the thread exits.
+       */
+      struct Cache {
+        std::array<std::vector<void*>, ClassesCount> blocks;
+        unsigned pooled = 0u;
+
+        ~Cache() {
+          destroyed = true;
+
+          for (unsigned id = 0u ; id < blocks.size() ; ++id) {
+            for (std::vector<void*>::const_iterator block = blocks[id].cbegin() ; block != blocks[id].cend() ; ++block) {
+              ::operator delete(*block);
+            }
+          }
+        }
+      };
+
+      /**
+       * @brief - Returns the cache of the calling thread or `null` if it has already
+       *          been destroyed.
+       */
+      Cache*
+      getCache() noexcept {
+        if (destroyed) {
+          return nullptr;
+        }
+
+        thread_local Cache cache;
+        return &cache;
+      }
+
+      /**
+       * @brief - Returns the size class of a block of the specified size or
+       *          `ClassesCount` if such a block should not be pooled.
+       */
+      std::size_t
+      getSizeClass(std::size_t bytes) noexcept {
+        if (bytes == 0u) {
+          return 0u;
+        }
+
+        return std::min((bytes - 1u) / Granularity, ClassesCount);
+      }
+
+    }
+
+    unsigned
+    EventsPool::getLiveCount() noexcept {
+      return live.load(std::memory_order_relaxed);
+    }
+
+    unsigned
+    EventsPool::getPeakCount() noexcept {
+      return peak.load(std::memory_order_relaxed);
+    }
+
+    unsigned
+    EventsPool::getPooledCount() noexcept {
+      const Cache* cache = getCache();
+      return (cache == nullptr ? 0u : cache->pooled);
+    }
+
+    void
+    EventsPool::setCapacity(unsigned count) noexcept {
+      capacity.store(count, std::memory_order_relaxed);
+    }
+
+    void*
+    EventsPool::acquire(std::size_t bytes) {
+      const std::size_t sizeClass = getSizeClass(bytes);
+
+      void* block = nullptr;
+
+      // Reuse a free block if one is available.
+      Cache* cache = getCache();
+
+      if (sizeClass < ClassesCount && cache != nullptr && !cache->blocks[sizeClass].empty()) {
+        block = cache->blocks[sizeClass].back();
+        cache->blocks[sizeClass].pop_back();
+        --cache->pooled;
+      }
+
+      // Otherwise allocate a new block with the full size of the class so
+      // that it can be reused by any event of this class.
+      if (block == nullptr) {
+        block = ::operator new(sizeClass < ClassesCount ? (sizeClass + 1u) * Granularity : bytes);
+      }
+
+      const unsigned count = live.fetch_add(1u, std::memory_order_relaxed) + 1u;
+
+      unsigned max = peak.load(std::memory_order_relaxed);
+      while (count > max && !peak.compare_exchange_weak(max, count, std::memory_order_relaxed)) {}
+
+      return block;
+    }
+
+    void
+    EventsPool::release(void* block,
+                        std::size_t bytes) noexcept
+    {
+      if (block == nullptr) {
+        return;
+      }
+
+      live.fetch_sub(1u, std::memory_order_relaxed);
+
+      const std::size_t sizeClass = getSizeClass(bytes);
+      Cache* cache = getCache();
+
+      if (sizeClass >= ClassesCount || cache == nullptr) {
+        ::operator delete(block);
+        return;
+      }
+
+      std::vector<void*>& blocks = cache->blocks[sizeClass];
+      const unsigned limit = capacity.load(std::memory_order_relaxed);
+
+      // Trim the free blocks if the capacity has been reduced.
+      while (blocks.size() > limit) {
+        ::operator delete(blocks.back());
+        blocks.pop_back();
+        --cache->pooled;
+      }
+
+      // Keep the block for future events if there's room for it. Pushing a
+      // block can only throw if the list needs to grow: in this case the
+      // block is returned to the heap.
+      if (blocks.size() < limit) {
+        try {
+          blocks.push_back(block);
+          ++cache->pooled;
+
+          return;
+        }
+        catch (...) {}
+      }
+
+      ::operator delete(block);
+    }
+
+  }
+}
@@ -0,0 +1,130 @@
+#ifndef    EVENTS_POOL_HH
+# define   EVENTS_POOL_HH
+
+# include <memory>
+# include <cstddef>
+
+namespace sdl {
+  namespace core {
+
+    class EventsPool {
+      public:
+
+        /**
+         * @brief - Creates a new event of the specified type with the input arguments.
+         *          The memory of the event (and of its reference counter) is taken from
+         *          a pool of blocks released by previous events instead of the heap:
+         *          this avoids most of the allocations for the events which are posted
+         *          at a high rate (repaint, resize, geometry updates, etc.).
+         *          Each thread keeps its own free blocks so that no lock is needed: a
+         *          block released by another thread than the one which acquired it is
+         *          kept by the releasing thread.
+         *          The returned pointer can be used like any other shared pointer and
+         *          the memory returns to the pool when the last reference is released.
+         * @param args - the arguments to forward to the constructor of the event.
+         * @return - a shared pointer on the created event.
+         */
+        template <typename Event, typename... Args>
+        static
+        std::shared_ptr<Event>
+        create(Args&&... args);
+
+        /**
+         * @brief - Returns the number of blocks currently used by events created through
+         *          the pool.
+         * @return - the number of live blocks.
+         */
+        static
+        unsigned
+        getLiveCount() noexcept;
+
+        /**
+         * @brief - Returns the maximum number of blocks simultaneously used by events
+         *          since the creation of the pool. This can be used to size the pool.
+         * @return - the peak number of live blocks.
+         */
+        static
+        unsigned
+        getPeakCount() noexcept;
+
+        /**
+         * @brief - Returns the number of free blocks kept for the calling thread.
+         * @return - the number of free blocks available to the calling thread.
+         */
+        static
+        unsigned
+        getPooledCount() noexcept;
+
+        /**
+         * @brief - Defines the maximum number of free blocks kept by each thread for each
+         *          size class: blocks released when the limit is reached are returned to
+         *          the heap. Free blocks above the limit are released by each thread the
+         *          next time it releases a block.
+         * @param capacity - the maximum number of free blocks per size class.
+         */
+        static
+        void
+        setCapacity(unsigned capacity) noexcept;
+
+        /**
+         * @brief - Allocates a block of memory able to hold `bytes` bytes. Blocks are
+         *          grouped in size classes so that events of similar sizes can share
+         *          the same blocks. Large blocks are directly taken from the heap.
+         * @param bytes - the size of the block to allocate.
+         * @return - a pointer to the block.
+         */
+        static
+        void*
+        acquire(std::size_t bytes);
+
+        /**
+         * @brief - Returns the block to the pool. The `bytes` should be identical to the
+         *          value provided when the block was acquired.
+         * @param block - the block to release.
+         * @param bytes - the size of the block.
+         */
+        static
+        void
+        release(void* block,
+                std::size_t bytes) noexcept;
+
+      private:
+
+        /**
+         * @brief - Allocator used to create events through `std::allocate_shared` with
+         *          the blocks of the pool.
+         */
+        template <typename T>
+        class Allocator {
+          public:
+
+            using value_type = T;
+
+            Allocator() noexcept = default;
+
+            template <typename U>
+            Allocator(const Allocator<U>& /*other*/) noexcept {}
+
+            T*
+            allocate(std::size_t count);
+
+            void
+            deallocate(T* block,
+                       std::size_t count) noexcept;
+
+            template <typename U>
+            bool
+            operator==(const Allocator<U>& /*rhs*/) const noexcept;
+
+            template <typename U>
+            bool
+            operator!=(const Allocator<U>& /*rhs*/) const noexcept;
+        };
+    };
+
+  }
+}
+
+# include "EventsPool.hxx"
+
+#endif    /* EVENTS_POOL_HH */
@@ -0,0 +1,53 @@
+#ifndef    EVENTS_POOL_HXX
+# define   EVENTS_POOL_HXX
+
+# include "EventsPool.hh"
+
+namespace sdl {
+  namespace core {
+
+    template <typename Event, typename... Args>
+    inline
+    std::shared_ptr<Event>
+    EventsPool::create(Args&&... args) {
+      return std::allocate_shared<Event>(Allocator<Event>(), std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    inline
+    T*
+    EventsPool::Allocator<T>::allocate(std::size_t count) {
+      static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned events cannot be pooled");
+      return static_cast<T*>(EventsPool::acquire(count * sizeof(T)));
+    }
+
+    template <typename T>
+    inline
+    void
+    EventsPool::Allocator<T>::deallocate(T* block,
+                                         std::size_t count) noexcept
+    {
+      EventsPool::release(block, count * sizeof(T));
+    }
+
+    template <typename T>
+    template <typename U>
+    inline
+    bool
+    EventsPool::Allocator<T>::operator==(const Allocator<U>& /*rhs*/) const noexcept {
+      // All the allocators share the same pool.
+      return true;
+    }
+
+    template <typename T>
+    template <typename U>
+    inline
+    bool
+    EventsPool::Allocator<T>::operator!=(const Allocator<U>& /*rhs*/) const noexcept {
+      return false;
+    }
+
+  }
+}
+
+#endif    /* EVENTS_POOL_HXX */
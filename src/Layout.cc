@@ -1,6 +1,8 @@
 
 # include "Layout.hh"
 # include "SdlWidget.hh"
+# include <functional>
+# include <algorithm>
 
 namespace sdl {
   namespace core {
@@ -11,9 +13,32 @@ namespace sdl {
                    const BoxesFormat& format):
       LayoutItem(name, utils::Sizef()),
       m_items(),
+      m_itemsIndex(),
+      m_itemsOrder(0u),
       m_margin(utils::Sizef(margin, margin)),
       m_boxesFormat(format),
-      m_nesting(Nesting::Root)
+      m_nesting(Nesting::Root),
+      m_hitIndex(),
+      m_hitIndexLocker(),
+      m_hitUpdates(),
+      m_hitRefresh(),
+      m_hitUpdatesLocker(),
+      m_synchronous(false),
+
+      m_geometryCache(),
+      m_geometryCacheCapacity(DefaultGeometryCacheCapacity),
+      m_recording(nullptr),
+      m_geometryKey(),
+
+      m_geometryCacheHits(0u),
+      m_geometryCacheMisses(0u),
+
+      m_container(widget),
+      m_batching(false),
+      m_transaction(),
+
+      m_paintOrder(),
+      m_paintOrderEpoch(0u)
     {
       // Assign the events queue from the container if needed.
       if (widget != nullptr) {
@@ -39,58 +64,40 @@ namespace sdl {
 
     const LayoutItem*
     Layout::getItemAt(const utils::Vector2f& pos) const noexcept {
-      // In order to find the best suited widget we need to traverse the list of all
-      // the registered items and try for each one to determine whether it is more
-      // relevant than the others.
-      std::vector<const LayoutItem*> items;
-
-      for (Items::const_iterator it = m_items.cbegin() ; it != m_items.cend() ; ++it) {
-        LayoutItem* item = *it;
-
-        const LayoutItem* best = item->getItemAt(pos);
-        if (best != nullptr) {
-          items.push_back(best);
-        }
-      }
-
-      // Now that we have the list of elements spanning the input position, we can
-      // perform a sort of the list and select the one with higher order. If we use
-      // an ordering where the smallest z order are in front of the sorted array,
-      // we need to retrieve the last one first.
-      std::sort(items.begin(), items.end(),
-        [](const LayoutItem* lhs, const LayoutItem* rhs) {
-          // Similarly to what is done in the `getItemAt` method for the `SdlWidget`
-          // class the goal here is to sort the items based on their total order in
-          // the hierarchy of this layout and not only based on their own proper `z`
-          // order: indeed when comparing two elements of a distinct hierarchy we
-          // wouldn't know how to interpret the order as both elements might be
-          // nested at very different levels in the hierarchy. Using the `z` order
-          // string helps put some context on these numbers.
-          return lhs->getZOrderString() < rhs->getZOrderString();
+      // In order to find the best suited widget we use the spatial index to
+      // only consider the items which might span the input position. These
+      // are visited by descending order of their position in the hierarchy:
+      // the first one which is able to provide a valid item is the best one.
+      // The items are indexed in the local frame of the container if any.
+      const utils::Vector2f local = (m_container != nullptr ? m_container->mapFromGlobal(pos) : pos);
+
+      const std::lock_guard guard(m_hitIndexLocker);
+      refreshHitIndex();
+
+      const LayoutItem* best = nullptr;
+      m_hitIndex.visit(local,
+        [&best, &pos](const LayoutItem* item) {
+          best = item->getItemAt(pos);
+          return best != nullptr;
         }
       );
 
-      // Check whether several items have the same z order: in this case it means
-      // that we are probably discarding elements which could have all the rights
-      // to be displayed as well.
-      if (items.size() >= 2) {
-        const LayoutItem* last = *items.rbegin();
-        const LayoutItem* secondToLast = *std::next(items.rbegin());
-
-        if (last->getZOrderString() == secondToLast->getZOrderString()) {
-          warn(
-            "Several items have the same z order (\"" + last->getZOrderString() + "\" and spans the same position, discarding \"" + secondToLast->getName() + "\"" +
-            " and possibly more in favor of \"" + last->getName() + "\""
-          );
-        }
-      }
+      return best;
+    }
 
-      // Return the last element of the sorted array if any.
-      if (items.empty()) {
-        return nullptr;
+    utils::Boxf
+    Layout::getHitArea() const noexcept {
+      // The bounds of the index correspond to the union of the hit areas of
+      // the visible items. As soon as an item is not able to provide a valid
+      // area we can't do better than an unknown area.
+      const std::lock_guard guard(m_hitIndexLocker);
+      refreshHitIndex();
+
+      if (!m_hitIndex.isBounded()) {
+        return utils::Boxf();
       }
 
-      return items.back();
+      return m_hitIndex.getBounds();
     }
 
     void
@@ -103,47 +110,254 @@ namespace sdl {
         return;
       }
 
-      // Proceed by activating the internal handler.
-      computeGeometry(window);
+      // Synchronous passes assign the areas directly and layouts which are
+      // not attached to a widget do not know where to post the repaint: in
+      // both cases there's no need for a transaction.
+      if (m_synchronous || m_container == nullptr) {
+        computeGeometryOrReplay(window);
+        return;
+      }
+
+      // Register the modifications of the items in a transaction which is
+      // applied once the geometry is computed.
+      m_transaction.assign(m_items.size(), GeometryChange{false, utils::Boxf(), false, false});
+      m_batching = true;
+
+      try {
+        computeGeometryOrReplay(window);
+      }
+      catch (...) {
+        m_batching = false;
+        m_transaction.clear();
+        throw;
+      }
+
+      m_batching = false;
+      commitTransaction();
+    }
+
+    void
+    Layout::computeGeometryOrReplay(const utils::Boxf& window) {
+      // Disable the cache if needed.
+      if (m_geometryCacheCapacity == 0u) {
+        computeGeometry(window);
+        return;
+      }
+
+      // Repeated updates with the same constraints (typically when the window
+      // is resized between a few known sizes) produce the same result: look
+      // for it in the cache before running the actual computation. Layouts not
+      // describing their parameters can't be cached though.
+      if (!buildGeometryRecord(window, m_geometryKey)) {
+        computeGeometry(window);
+        return;
+      }
+
+      std::list<GeometryRecord>::iterator cached = m_geometryCache.begin();
+      while (cached != m_geometryCache.end() && !hasSameInputs(*cached, m_geometryKey)) {
+        ++cached;
+      }
+
+      if (cached != m_geometryCache.end()) {
+        ++m_geometryCacheHits;
+
+        // Move the record to the front of the cache and replay the assignments.
+        m_geometryCache.splice(m_geometryCache.begin(), m_geometryCache, cached);
+
+        for (std::vector<Assignment>::const_iterator it = m_geometryCache.front().assignments.cbegin() ;
+             it != m_geometryCache.front().assignments.cend() ;
+             ++it)
+        {
+          if (it->visibility) {
+            assignVisibilityStatus(it->visible);
+          }
+          else {
+            assignRenderingAreas(it->boxes, it->window);
+          }
+        }
+
+        return;
+      }
+
+      ++m_geometryCacheMisses;
+
+      // Proceed by activating the internal handler, recording the assignments
+      // it performs.
+      GeometryRecord record = std::move(m_geometryKey);
+
+      m_recording = &record;
+      try {
+        computeGeometry(window);
+      }
+      catch (...) {
+        m_recording = nullptr;
+        throw;
+      }
+      m_recording = nullptr;
+
+      // Register the result in the cache.
+      m_geometryCache.push_front(std::move(record));
+      while (m_geometryCache.size() > m_geometryCacheCapacity) {
+        m_geometryCache.pop_back();
+      }
+    }
+
+    void
+    Layout::layoutSynchronously(const utils::Boxf& area) {
+      // Nested layouts of the items will be reached through the items
+      // themselves so we only need to flag this layout.
+      const bool previous = m_synchronous;
+      m_synchronous = true;
+
+      LayoutItem::layoutSynchronously(area);
+
+      m_synchronous = previous;
+    }
+
+    const std::vector<std::pair<ZOrderKey, LayoutItem*>>&
+    Layout::getPaintOrder() const {
+      // Use the cached order if the stacking order did not change: adding
+      // or removing items also invalidates the geometry epoch.
+      const unsigned epoch = getGeometryEpoch();
+      if (m_paintOrderEpoch == epoch) {
+        return m_paintOrder;
+      }
+
+      // The goal here is to sort the items based on their total order in the
+      // hierarchy of this layout and not only based on their own proper `z`
+      // order: see `refreshHitIndex` for more details. The storage of the
+      // vector is reused from one sort to the next.
+      m_paintOrder.clear();
+
+      for (Items::const_iterator it = m_items.cbegin() ; it != m_items.cend() ; ++it) {
+        m_paintOrder.push_back(std::make_pair((*it)->getZOrderKey(), *it));
+      }
+
+      std::stable_sort(m_paintOrder.begin(), m_paintOrder.end(),
+        [](const std::pair<ZOrderKey, LayoutItem*>& lhs, const std::pair<ZOrderKey, LayoutItem*>& rhs) {
+          return lhs.first < rhs.first;
+        }
+      );
+
+      m_paintOrderEpoch = epoch;
+
+      return m_paintOrder;
+    }
+
+    void
+    Layout::itemHitAreaChanged(const LayoutItem& item) {
+      {
+        const std::lock_guard guard(m_hitUpdatesLocker);
+
+        // In case the item is already queued, the manager of this layout was
+        // already notified as well.
+        if (markHitAreaPending(item, true)) {
+          return;
+        }
+
+        m_hitUpdates.push_back(&item);
+      }
+
+      // The hit area of this layout depends on the one of its items.
+      hitAreaChanged();
+    }
+
+    void
+    Layout::refreshHitIndex() const {
+      // Retrieve the items queued so far: the queue is swapped with the
+      // refresh buffer so that both keep their storage.
+      {
+        const std::lock_guard guard(m_hitUpdatesLocker);
+
+        if (m_hitUpdates.empty()) {
+          return;
+        }
+
+        for (std::vector<const LayoutItem*>::const_iterator item = m_hitUpdates.cbegin() ; item != m_hitUpdates.cend() ; ++item) {
+          markHitAreaPending(**item, false);
+        }
+
+        std::swap(m_hitUpdates, m_hitRefresh);
+      }
+
+      // The goal here is to sort the items based on their total order in the
+      // hierarchy of this layout and not only based on their own proper `z`
+      // order: indeed when comparing two elements of a distinct hierarchy we
+      // wouldn't know how to interpret the order as both elements might be
+      // nested at very different levels in the hierarchy. Using the `z` order
+      // key helps put some context on these numbers.
+      for (std::vector<const LayoutItem*>::const_iterator item = m_hitRefresh.cbegin() ; item != m_hitRefresh.cend() ; ++item) {
+        ItemsIndex::const_iterator indexed = m_itemsIndex.find(*item);
+        if (indexed == m_itemsIndex.cend()) {
+          continue;
+        }
+
+        if (!(*item)->isVisible()) {
+          m_hitIndex.remove(*item);
+          continue;
+        }
+
+        m_hitIndex.update(*item, (*item)->getHitArea(), std::make_pair((*item)->getZOrderKey(), indexed->second.order));
+      }
+
+      m_hitRefresh.clear();
+    }
+
+    void
+    Layout::removeFromHitIndex(const LayoutItem* item) {
+      m_hitIndex.remove(item);
+
+      const std::lock_guard guard(m_hitUpdatesLocker);
+
+      if (markHitAreaPending(*item, false)) {
+        m_hitUpdates.erase(std::find(m_hitUpdates.begin(), m_hitUpdates.end(), item));
+      }
     }
 
     bool
     Layout::filterKeyboardEvents(const engine::EngineObject* watched,
-                                 const engine::KeyEventShPtr /*e*/) const noexcept
+                                 const engine::KeyEvent& /*e*/) const noexcept
     {
       // We need to check whether the item corresponding to the input `watched` item
       // has the keyboard focus. If this is the case we can transmit the key event to
       // it otherwise we need to filter it.
-      // If the watched object cannot be found in the internal array, we consider that
+      // If the watched object cannot be found in the internal index, we consider that
       // the event is not filtered.
+      ItemsIndex::const_iterator item = m_itemsIndex.find(watched);
+      if (item == m_itemsIndex.cend()) {
+        // No child matches the input `watched` object: consider the event as not filtered.
+        return false;
+      }
 
-      // Traverse the internal list of items and stop as soon as we find the input
-      // `watched` object.
-      Items::const_iterator item = m_items.cbegin();
-      while (item != m_items.cend()) {
-        if (*item == watched) {
-          return !(*item)->hasKeyboardFocus();
-        }
+      return !item->second.item->hasKeyboardFocus();
+    }
 
-        ++item;
+    const LayoutItem*
+    Layout::resolveMouseTarget(const utils::Vector2f& pos) const noexcept {
+      // Layouts which are not attached to a widget perform the hit test
+      // on their own items.
+      if (m_container == nullptr) {
+        return LayoutItem::resolveMouseTarget(pos);
       }
 
-      // No child matches the input `watched` object: consider the event as not filtered.
-      return false;
+      // The container is always part of the filters applied to the items
+      // of this layout: using the target it resolved for the event does
+      // not change which item receives it.
+      return m_container->resolveMouseTarget(pos);
     }
 
     bool
     Layout::gainFocusEvent(const engine::FocusEvent& e) {
-      verbose("Handling gain focus from " + e.getEmitter()->getName());
+      lazyLog<LogLevel::Verbose>([&]() { return "Handling gain focus from " + e.getEmitter()->getName(); });
 
       // Traverse the list of items handled by this layout and
       // propagate a leave event to corresponding children which
       // still are focused.
       for (Items::const_iterator item = m_items.cbegin() ; item != m_items.cend() ; ++item) {
-        verbose("Item " + (*item)->getName() + ((*item)->hasFocus() ? " has " : " has not ") + "focus");
+        lazyLog<LogLevel::Verbose>([&]() { return "Item " + (*item)->getName() + ((*item)->hasFocus() ? " has " : " has not ") + "focus"; });
         // If the child is not the source of the event and is focused, unfocus it.
         if (!e.isEmittedBy(*item) && (*item)->hasFocus()) {
-          verbose("Posting focus out event on " + (*item)->getName() + " due to " + e.getEmitter()->getName() + " gaining focus");
+          lazyLog<LogLevel::Verbose>([&]() { return "Posting focus out event on " + (*item)->getName() + " due to " + e.getEmitter()->getName() + " gaining focus"; });
           postEvent(engine::FocusEvent::createFocusOutEvent(e.getReason(), false, *item), false);
         }
       }
@@ -177,30 +391,45 @@ namespace sdl {
       // - `B` updates its representation to include the content of `A` which is on top of it.
       // During this operation we get a flickering of the representation which could be improved.
 
-      notice(
-        "Handling repaint for event containing " + std::to_string(regions.size()) + " region(s) to update (source: " +
-        (e.getEmitter() == nullptr ? "null" : e.getEmitter()->getName()) + ")"
-      );
+      lazyLog<LogLevel::Notice>([&]() {
+        return
+          "Handling repaint for event containing " + std::to_string(regions.size()) + " region(s) to update (source: " +
+          (e.getEmitter() == nullptr ? "null" : e.getEmitter()->getName()) + ")"
+        ;
+      });
+
+      // Traverse the items by descending order of their `z` order key: this allows to accumulate
+      // the areas covered by opaque items and to avoid sending paint events for the parts of the
+      // items which are hidden below them.
+      const std::vector<std::pair<ZOrderKey, LayoutItem*>>& items = getPaintOrder();
+
+      std::vector<utils::Boxf> occluders;
 
       // Traverse the internal array of children.
-      for (Items::const_iterator child = m_items.cbegin() ;
-           child != m_items.cend() ;
-           ++child)
-      {
+      for (int rank = static_cast<int>(items.size()) - 1 ; rank >= 0 ; --rank) {
+        LayoutItem* child = items[rank].second;
+
+        // Opaque items hide the items below them even if they are not repainted.
+        const utils::Boxf childArea = child->getDrawingArea();
+        const bool opaque = child->isOpaque();
+
         // Discard this child if the emitter belongs to its hierarchy.
-        if (e.isEmittedBy(*child)) {
-          verbose("Ignoring child " + (*child)->getName() + " which is the source of the paint event");
+        if (e.isEmittedBy(child)) {
+          lazyLog<LogLevel::Verbose>([&]() { return "Ignoring child " + child->getName() + " which is the source of the paint event"; });
+          if (opaque) {
+            occluders.push_back(childArea);
+          }
           continue;
         }
 
         // Also disacrd the child if it is not visible.
-        if (!(*child)->isVisible()) {
-          verbose("Ignoring child " + (*child)->getName() + " which is not visible");
+        if (!child->isVisible()) {
+          lazyLog<LogLevel::Verbose>([&]() { return "Ignoring child " + child->getName() + " which is not visible"; });
           continue;
         }
 
         // Create a paint event for this children.
-        engine::PaintEventShPtr pe = std::make_shared<engine::PaintEvent>(*child);
+        engine::PaintEventShPtr pe = EventsPool::create<engine::PaintEvent>(child);
         pe->setEmitter(e.getEmitter());
 
         // Select only update areas which spans at least a portion
@@ -211,7 +440,7 @@ namespace sdl {
           if (regions[id].frame == engine::update::Frame::Local) {
             warn(
               std::string("Cannot determine whether update region " + regions[id].toString() +
-              " interesects \"") + (*child)->getName() + "\", region is in local coordinate frame"
+              " interesects \"") + child->getName() + "\", region is in local coordinate frame"
             );
 
             // Move on to the next region and don't add this one for the current event.
@@ -219,10 +448,35 @@ namespace sdl {
           }
 
           // The region is in global coordinate frame, check intersections.
-          if (regions[id].area.intersects((*child)->getDrawingArea(), true)) {
-            debug("Area " + std::to_string(id) + " (" + regions[id].toString() + ") intersects area of " + (*child)->getName() + " (area: " + (*child)->getDrawingArea().toString() + ")");
-            pe->addUpdateRegion(regions[id]);
+          if (!regions[id].area.intersects(childArea, true)) {
+            continue;
           }
+
+          // Remove the parts of the region which are hidden by opaque items
+          // located above this child.
+          Region visible(regions[id].area.intersect(childArea));
+          for (std::vector<utils::Boxf>::const_iterator occ = occluders.cbegin() ; occ != occluders.cend() ; ++occ) {
+            visible.subtract(*occ);
+          }
+
+          if (visible.empty()) {
+            lazyLog<LogLevel::Debug>([&]() { return "Area " + std::to_string(id) + " (" + regions[id].toString() + ") is hidden for " + child->getName(); });
+            continue;
+          }
+
+          lazyLog<LogLevel::Debug>([&]() { return "Area " + std::to_string(id) + " (" + regions[id].toString() + ") intersects area of " + child->getName() + " (area: " + childArea.toString() + ")"; });
+
+          const Region::Rectangles& parts = visible.getRectangles();
+          for (Region::Rectangles::const_iterator part = parts.cbegin() ; part != parts.cend() ; ++part) {
+            engine::update::Region piece = regions[id];
+            piece.area = *part;
+
+            pe->addUpdateRegion(piece);
+          }
+        }
+
+        if (opaque) {
+          occluders.push_back(childArea);
         }
 
         // Send this event if it contains at least an update area.
@@ -230,7 +484,7 @@ namespace sdl {
           postEvent(pe, false, false);
         }
         else {
-          debug("Ignoring child " + (*child)->getName() + " not intersecting any update region");
+          lazyLog<LogLevel::Debug>([&]() { return "Ignoring child " + child->getName() + " not intersecting any update region"; });
         }
       }
 
@@ -256,9 +510,19 @@ namespace sdl {
 
       // Insert the item into the layout.
       m_items.push_back(item);
+      {
+        const std::lock_guard guard(m_hitIndexLocker);
+        m_itemsIndex[item] = IndexedItem{item, m_itemsOrder++};
+      }
+      clearGeometryCache();
 
-      // Set this item as `managed` by this layout.
+      // The hit targets memorized by the items are not valid anymore.
+      invalidateGeometryEpoch();
+
+      // Set this item as `managed` by this layout and register it in the
+      // spatial index.
       item->setManager(this);
+      itemHitAreaChanged(*item);
 
       // Compute the physical id of this item.
       const int physID = m_items.size() - 1;
@@ -298,6 +562,11 @@ namespace sdl {
     Layout::assignRenderingAreas(const std::vector<utils::Boxf>& boxes,
                                  const utils::Boxf& window)
     {
+      // Record the assignment if needed.
+      if (m_recording != nullptr) {
+        m_recording->assignments.push_back(Assignment{false, boxes, window, std::vector<bool>()});
+      }
+
       // Assign the rendering area to items.
       for (unsigned index = 0u; index < boxes.size() ; ++index) {
         // The origin of the coordinate frame of the rendering areas is defined as
@@ -350,20 +619,80 @@ namespace sdl {
         }
 
         // debug("Area for " + m_items[index]->getName() + " is " + converted.toString() + " from " + boxes[index].toString() + " (window: " + window.toString() + ")");
-        debug("Area for " + m_items[index]->getName() + " is " + converted.toString());
+        lazyLog<LogLevel::Debug>([&]() { return "Area for " + m_items[index]->getName() + " is " + converted.toString(); });
 
-        postEvent(std::make_shared<engine::ResizeEvent>(converted, m_items[index]->getRenderingArea(), m_items[index]));
+        if (m_synchronous) {
+          m_items[index]->layoutSynchronously(converted);
+          continue;
+        }
+
+        if (m_batching) {
+          m_transaction[index].resized = true;
+          m_transaction[index].area = converted;
+          continue;
+        }
+
+        postEvent(EventsPool::create<engine::ResizeEvent>(converted, m_items[index]->getRenderingArea(), m_items[index]));
       }
     }
 
     void
     Layout::assignVisibilityStatus(const std::vector<bool>& visible) {
+      // Record the assignment if needed.
+      if (m_recording != nullptr) {
+        m_recording->assignments.push_back(Assignment{true, std::vector<utils::Boxf>(), utils::Boxf(), visible});
+      }
+
       // Assign the rendering area to items.
       for (unsigned index = 0u; index < visible.size() ; ++index) {
+        if (m_batching) {
+          m_transaction[index].toggled = true;
+          m_transaction[index].visible = visible[index];
+          continue;
+        }
+
         m_items[index]->setVisible(visible[index]);
       }
     }
 
+    void
+    Layout::commitTransaction() {
+      // Apply the modifications to each item and gather the regions which
+      // need to be repainted in the container.
+      engine::PaintEventShPtr pe = nullptr;
+
+      for (unsigned index = 0u ; index < m_transaction.size() && index < m_items.size() ; ++index) {
+        const GeometryChange& change = m_transaction[index];
+        if (!change.resized && !change.toggled) {
+          continue;
+        }
+
+        const std::vector<utils::Boxf> regions = m_items[index]->commitGeometry(change);
+
+        for (std::vector<utils::Boxf>::const_iterator region = regions.cbegin() ; region != regions.cend() ; ++region) {
+          if (pe == nullptr) {
+            pe = EventsPool::create<engine::PaintEvent>(*region);
+          }
+          else {
+            pe->merge(engine::PaintEvent(*region));
+          }
+        }
+      }
+
+      m_transaction.clear();
+
+      if (pe == nullptr) {
+        return;
+      }
+
+      // The event is handled by the container as if it was emitted by itself
+      // which is similar to what happens when a child is hidden.
+      pe->setEmitter(m_container);
+      pe->setReceiver(m_container);
+
+      postEvent(pe, false, false);
+    }
+
     SizePolicy
     Layout::shrinkOrGrow(const utils::Sizef& desiredSize,
                          const utils::Sizef& achievedSize,
@@ -373,36 +702,135 @@ namespace sdl {
       SizePolicy policy;
 
       // Compare the `achievedSize` to the `desiredSize` and determine the action
-      // to apply both horizontally and vertically.
-      if (std::abs(desiredSize.w() - achievedSize.w()) < tolerance) {
-        // Consider that the `achievedSize` is close enough from the `desiredSize`
-        // to keep it.
-      }
-      else if (desiredSize.w() < achievedSize.w()) {
-        notice(std::string("achieved.w() > desired.w() (") + std::to_string(achievedSize.w()) + " > " + std::to_string(desiredSize.w()) + "), shrinking");
+      // to apply both horizontally and vertically. Sizes close enough from the
+      // `desiredSize` are kept.
+      const std::uint32_t horizontal = layout::resolveAction(desiredSize.w(), achievedSize.w(), tolerance);
+      const std::uint32_t vertical = layout::resolveAction(desiredSize.h(), achievedSize.h(), tolerance);
+
+      if (horizontal == layout::Constraint::Shrink) {
+        lazyLog<LogLevel::Notice>([&]() { return std::string("achieved.w() > desired.w() (") + std::to_string(achievedSize.w()) + " > " + std::to_string(desiredSize.w()) + "), shrinking"; });
         policy.setHorizontalPolicy(SizePolicy::Name::Maximum);
       }
-      else if (desiredSize.w() > achievedSize.w()) {
-        notice(std::string("achieved.w() < desired.w() (") + std::to_string(achievedSize.w()) + " < " + std::to_string(desiredSize.w()) + "), growing");
+      else if (horizontal == layout::Constraint::Extend) {
+        lazyLog<LogLevel::Notice>([&]() { return std::string("achieved.w() < desired.w() (") + std::to_string(achievedSize.w()) + " < " + std::to_string(desiredSize.w()) + "), growing"; });
         policy.setHorizontalPolicy(SizePolicy::Name::Minimum);
       }
 
-      if (std::abs(desiredSize.h() - achievedSize.h()) < tolerance) {
-        // Consider that the `achievedSize` is close enough from the `desiredSize`
-        // to keep it.
-      }
-      else if (desiredSize.h() < achievedSize.h()) {
-        notice(std::string("achieved.h() > desired.h() (") + std::to_string(achievedSize.h()) + " > " + std::to_string(desiredSize.h()) + "), shrinking");
+      if (vertical == layout::Constraint::Shrink) {
+        lazyLog<LogLevel::Notice>([&]() { return std::string("achieved.h() > desired.h() (") + std::to_string(achievedSize.h()) + " > " + std::to_string(desiredSize.h()) + "), shrinking"; });
         policy.setVerticalPolicy(SizePolicy::Name::Maximum);
       }
-      else if (desiredSize.h() > achievedSize.h()) {
-        notice(std::string("achieved.h() < desired.h() (") + std::to_string(achievedSize.h()) + " < " + std::to_string(desiredSize.h()) + "), growing");
+      else if (vertical == layout::Constraint::Extend) {
+        lazyLog<LogLevel::Notice>([&]() { return std::string("achieved.h() < desired.h() (") + std::to_string(achievedSize.h()) + " < " + std::to_string(desiredSize.h()) + "), growing"; });
         policy.setVerticalPolicy(SizePolicy::Name::Minimum);
       }
 
       return policy;
     }
 
+    bool
+    Layout::buildGeometryRecord(const utils::Boxf& window,
+                                GeometryRecord& record) const
+    {
+      // Retrieve the parameters of the inheriting layout first: if they are not
+      // described there's no point in building the rest of the record.
+      record.parameters.clear();
+      if (!describeGeometryInputs(record.parameters)) {
+        return false;
+      }
+
+      record.hash = 0u;
+      record.window = window;
+      record.margin = m_margin;
+      record.format = m_boxesFormat;
+      record.nesting = m_nesting;
+      record.assignments.clear();
+
+      // Fill the constraints of the items in place: the rendering areas and the
+      // visibility status are not part of the inputs as they are assigned by the
+      // layout itself, so we don't retrieve them.
+      record.items.resize(m_items.size());
+
+      for (unsigned index = 0u ; index < m_items.size() ; ++index) {
+        WidgetInfo& info = record.items[index];
+
+        info.policy = m_items[index]->getSizePolicy();
+        info.min = m_items[index]->getMinSize();
+        info.hint = m_items[index]->getSizeHint();
+        info.max = m_items[index]->getMaxSize();
+      }
+
+      // Combine the inputs into a hash used to quickly discard records which
+      // do not match.
+      const auto combine = [&record](float value) {
+        record.hash ^= std::hash<float>()(value) + 0x9e3779b9u + (record.hash << 6u) + (record.hash >> 2u);
+      };
+
+      combine(window.x());
+      combine(window.y());
+      combine(window.w());
+      combine(window.h());
+
+      for (std::vector<WidgetInfo>::const_iterator it = record.items.cbegin() ;
+           it != record.items.cend() ;
+           ++it)
+      {
+        combine(it->min.w());
+        combine(it->min.h());
+        combine(it->hint.w());
+        combine(it->hint.h());
+        combine(it->max.w());
+        combine(it->max.h());
+        combine(it->policy.getHorizontalStretch());
+        combine(it->policy.getVerticalStretch());
+      }
+
+      for (std::vector<float>::const_iterator it = record.parameters.cbegin() ;
+           it != record.parameters.cend() ;
+           ++it)
+      {
+        combine(*it);
+      }
+
+      return true;
+    }
+
+    bool
+    Layout::hasSameInputs(const GeometryRecord& lhs,
+                          const GeometryRecord& rhs) noexcept
+    {
+      if (lhs.hash != rhs.hash || lhs.items.size() != rhs.items.size() ||
+          lhs.parameters != rhs.parameters)
+      {
+        return false;
+      }
+
+      if (lhs.window.x() != rhs.window.x() || lhs.window.y() != rhs.window.y() ||
+          lhs.window.w() != rhs.window.w() || lhs.window.h() != rhs.window.h() ||
+          lhs.margin.w() != rhs.margin.w() || lhs.margin.h() != rhs.margin.h() ||
+          lhs.format != rhs.format || lhs.nesting != rhs.nesting)
+      {
+        return false;
+      }
+
+      // Note that the rendering areas of the items are not considered: these are
+      // the outputs of the computation.
+      for (unsigned id = 0u ; id < lhs.items.size() ; ++id) {
+        const WidgetInfo& l = lhs.items[id];
+        const WidgetInfo& r = rhs.items[id];
+
+        if (l.policy != r.policy ||
+            l.min.w() != r.min.w() || l.min.h() != r.min.h() ||
+            l.hint.w() != r.hint.w() || l.hint.h() != r.hint.h() ||
+            l.max.w() != r.max.w() || l.max.h() != r.max.h())
+        {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
     std::vector<Layout::WidgetInfo>
     Layout::computeItemsInfo() const noexcept {
       // Create the return value.
@@ -423,65 +851,56 @@ namespace sdl {
       return info;
     }
 
-    float
-    Layout::computeWidthFromPolicy(const utils::Boxf& currentSize,
-                                   float delta,
-                                   const WidgetInfo& info) const
-    {
-      // Create the return width and assume the desired width is valid.
-      float output = currentSize.w() + delta;
-
-      bool widthDone = false;
-
-      // Check the policy for fixed size. If the policy is fixed, we should assign
-      // the `hint` size whatever the input `delta`. Except of course if the
-      // `hint` is not a valid size, in which case we can use the `sizeDelta`.
-      if (info.policy.isFixedHorizontally()) {
-        // Two distinct cases:
-        // 1) The `hint` is valid, in which case we have to use it.
-        // 2) The `hint` is not valid in which case we have to use the `sizeDelta`.
-        if (info.hint.isValid()) {
-          output = info.hint.w();
-          widthDone = true;
-        }
-      }
+    Layout::ItemsInfo
+    Layout::computeItemsArrays() const noexcept {
+      ItemsInfo info;
 
-      // Check whether we should continue further.
-      if (widthDone) {
-        return output;
+      for (unsigned index = 0u ; index < m_items.size() ; ++index) {
+        appendItem(
+          info,
+          m_items[index]->getSizePolicy(),
+          m_items[index]->getMinSize(),
+          m_items[index]->getSizeHint(),
+          m_items[index]->getMaxSize(),
+          m_items[index]->getRenderingArea(),
+          m_items[index]->isVisible()
+        );
       }
 
-      // The width is not set to fixed so we have to check for min and max sizes.
-      if (output < info.min.w()) {
-        output = info.min.w();
-      }
-      if (output > info.max.w()) {
-        output = info.max.w();
-      }
+      return info;
+    }
 
-      // The last thing to check concerns the size policy. For example if the `output`
-      // is larger than the provided hint, even though the `output` is smaller than the
-      // `maxSize`, if the policy is not set to `Grow`, we should still use the `hint` size.
-      // Same goes for the case where the `output` lies in the interval [`minSize`; `hint`]
-      // and the policy is not set to `Shrink`: the `hint` should be used.
-      // If course all this is only relevant if the hint is valid, otherwise we can use the
-      // `output`.
-      if (!info.hint.isValid()) {
-        // Nothing more to do, the `output` can be used once clamped using the `minSize`
-        // and `maxSize`.
-        return output;
-      }
+    Layout::ItemsInfo
+    Layout::computeItemsArrays(const std::vector<WidgetInfo>& info) noexcept {
+      ItemsInfo out;
 
-      // Check shrinking policy.
-      if (output < info.hint.w() && !info.policy.canShrinkHorizontally()) {
-        output = info.hint.w();
-      }
-      if (output > info.hint.w() && !info.policy.canExtendHorizontally()) {
-        output = info.hint.w();
+      for (std::vector<WidgetInfo>::const_iterator it = info.cbegin() ; it != info.cend() ; ++it) {
+        appendItem(out, it->policy, it->min, it->hint, it->max, it->area, it->visible);
       }
 
-      // We can return the computed width.
-      return output;
+      return out;
+    }
+
+    float
+    Layout::computeWidthFromPolicy(const utils::Boxf& currentSize,
+                                   float delta,
+                                   const WidgetInfo& info) const
+    {
+      // The rules are shared with `computeSizesFromPolicy` so that both the
+      // per item and the arrays representations produce the same sizes.
+      return layout::clamp(
+        currentSize.w(),
+        delta,
+        info.min.w(),
+        info.hint.w(),
+        info.max.w(),
+        layout::toConstraints(
+          info.hint.isValid(),
+          info.policy.isFixedHorizontally(),
+          info.policy.canShrinkHorizontally(),
+          info.policy.canExtendHorizontally()
+        )
+      );
     }
 
     float
@@ -489,60 +908,21 @@ namespace sdl {
                                     float delta,
                                     const WidgetInfo& info) const
     {
-      // Create the return height and assume the desired height is valid.
-      float output = currentSize.h() + delta;
-
-      bool heightDone = false;
-
-      // Check the policy for fixed size. If the policy is fixed, we should assign
-      // the `hint` size whatever the input `delta`. Except of course if the
-      // `hint` is not a valid size, in which case we can use the `sizeDelta`.
-      if (info.policy.isFixedVertically()) {
-        // Two distinct cases:
-        // 1) The `hint` is valid, in which case we have to use it.
-        // 2) The `hint` is not valid in which case we have to use the `sizeDelta`.
-        if (info.hint.isValid()) {
-          output = info.hint.h();
-          heightDone = true;
-        }
-      }
-
-      // Check whether we should continue further.
-      if (heightDone) {
-        return output;
-      }
-
-      // The height is not set to fixed so we have to check for min and max sizes.
-      if (output < info.min.h()) {
-        output = info.min.h();
-      }
-      if (output > info.max.h()) {
-        output = info.max.h();
-      }
-
-      // The last thing to check concerns the size policy. For example if the `output`
-      // is larger than the provided hint, even though the `output` is smaller than the
-      // `maxSize`, if the policy is not set to `Grow`, we should still use the `hint` size.
-      // Same goes for the case where the `output` lies in the interval [`minSize`; `hint`]
-      // and the policy is not set to `Shrink`: the `hint` should be used.
-      // If course all this is only relevant if the hint is valid, otherwise we can use the
-      // `output`.
-      if (!info.hint.isValid()) {
-        // Nothing more to do, the `output` can be used once clamped using the `minSize`
-        // and `maxSize`.
-        return output;
-      }
-
-      // Check shrinking policy.
-      if (output < info.hint.h() && !info.policy.canShrinkVertically()) {
-        output = info.hint.h();
-      }
-      if (output > info.hint.h() && !info.policy.canExtendVertically()) {
-        output = info.hint.h();
-      }
-
-      // We can return the computed height.
-      return output;
+      // The rules are shared with `computeSizesFromPolicy` so that both the
+      // per item and the arrays representations produce the same sizes.
+      return layout::clamp(
+        currentSize.h(),
+        delta,
+        info.min.h(),
+        info.hint.h(),
+        info.max.h(),
+        layout::toConstraints(
+          info.hint.isValid(),
+          info.policy.isFixedVertically(),
+          info.policy.canShrinkVertically(),
+          info.policy.canExtendVertically()
+        )
+      );
     }
 
     utils::Sizef
@@ -557,6 +937,38 @@ namespace sdl {
       );
     }
 
+    std::vector<utils::Sizef>
+    Layout::computeSizesFromPolicy(const ItemsInfo& info,
+                                   const std::vector<utils::Sizef>& deltas) const
+    {
+      const unsigned count = info.horizontal.current.size();
+
+      if (deltas.size() != count) {
+        error(
+          std::string("Cannot compute sizes from policy"),
+          std::string("Expected ") + std::to_string(count) + " delta(s) but got " + std::to_string(deltas.size())
+        );
+      }
+
+      // Split the deltas per axis so that each axis can be processed as a
+      // contiguous array. The kernels write the sizes in place.
+      std::vector<float> w(count), h(count);
+      for (unsigned id = 0u ; id < count ; ++id) {
+        w[id] = deltas[id].w();
+        h[id] = deltas[id].h();
+      }
+
+      layout::clampAxis(info.horizontal, w.data(), w.data());
+      layout::clampAxis(info.vertical, h.data(), h.data());
+
+      std::vector<utils::Sizef> sizes(count);
+      for (unsigned id = 0u ; id < count ; ++id) {
+        sizes[id] = utils::Sizef(w[id], h[id]);
+      }
+
+      return sizes;
+    }
+
     std::pair<bool, bool>
     Layout::canBeUsedTo(const WidgetInfo& info,
                         const utils::Boxf& box,
@@ -566,114 +978,114 @@ namespace sdl {
       // information `info` can be used to perform the required
       // operation described in the input `policy` action in the
       // specified direction.
-      // We want to return true if the item can be used to perform
-      // at least one of the `action` described by the input
-      // argument.
       // The returned value corresponds to a pair describing in
       // its first member whether the item can be used to perform
       // the `action.getHorizontalPolicy()` and on its second member
       // whether the item can be used to perform the action
       // described by `action.getVerticalPolicy()`.
-      std::pair<bool, bool> usable = std::make_pair(false, false);
-
-      // Let's first handle the case where no valid hint is provided.
-      if (!info.hint.isValid()) {
-        // The result of this function is solely based on the current
-        // size of the item versus the `min` and `max` size.
-        // Also, we need to consider both directions: as soon as a
-        // valid `action` can be performed, we need to return but
-        // failure to perform one action should not stop the process.
-
-        // Check for shrinking.
-        if (action.canShrinkHorizontally() && box.w() > info.min.w()) {
-          usable.first = true;
-        }
-        if (action.canShrinkVertically() && box.h() > info.min.h()) {
-          usable.second = true;
-        }
+      // If an hint is provided it replaces the `min` size for items
+      // which can't shrink and the `max` size for items which can't
+      // grow: the rules are shared with the arrays representation.
+      const std::pair<std::uint32_t, std::uint32_t> actions = toActions(action);
+      const bool hintValid = info.hint.isValid();
+
+      return std::make_pair(
+        layout::isUsable(
+          box.w(),
+          info.min.w(),
+          info.hint.w(),
+          info.max.w(),
+          layout::toConstraints(
+            hintValid,
+            info.policy.isFixedHorizontally(),
+            info.policy.canShrinkHorizontally(),
+            info.policy.canExtendHorizontally()
+          ),
+          actions.first
+        ),
+        layout::isUsable(
+          box.h(),
+          info.min.h(),
+          info.hint.h(),
+          info.max.h(),
+          layout::toConstraints(
+            hintValid,
+            info.policy.isFixedVertically(),
+            info.policy.canShrinkVertically(),
+            info.policy.canExtendVertically()
+          ),
+          actions.second
+        )
+      );
+    }
 
-        // Check for growing.
-        if (action.canExtendHorizontally() && box.w() < info.max.w()) {
-          usable.first = true;
-        }
-        if (action.canExtendVertically() && box.h() < info.max.h()) {
-          usable.second = true;
-        }
-      }
+    std::vector<std::pair<bool, bool>>
+    Layout::canBeUsedTo(const ItemsInfo& info,
+                        const SizePolicy& action) const
+    {
+      const unsigned count = info.horizontal.current.size();
+      const std::pair<std::uint32_t, std::uint32_t> actions = toActions(action);
 
-      // If an hint is provided, we also need to compare the box to the
-      // hint. Indeed in case the policy is set to `Shrink` for example,
-      // if an hint is provided if effectively replace the `max` size
-      // for all intent and purposes.
-      // Respectively if the policy is set to `Grow` and an hint is
-      // provided, the `hint` replaces the `min` size.
-
-      if (info.hint.isValid()) {
-        // Check for shrinking.
-        if (action.canShrinkHorizontally()) {
-          // The action requires to shrink: the item can do that if
-          // its policy is set to `Shrink` and the current size is
-          // larger than the `min` or if the policy is NOT set with
-          // the `Shrink` flag, the `hint` replaces the value.
-          if (info.policy.canShrinkHorizontally() && box.w() > info.min.w()) {
-            usable.first = true;
-          }
-          if (!info.policy.canShrinkHorizontally() && box.w() > info.hint.w()) {
-            usable.first = true;
-          }
-        }
-        if (action.canShrinkVertically()) {
-          // The action requires to shrink: the item can do that if
-          // its policy is set to `Shrink` and the current size is
-          // larger than the `min` or if the policy is NOT set with
-          // the `Shrink` flag, the `hint` replaces the value.
-          if (info.policy.canShrinkVertically() && box.h() > info.min.h()) {
-            usable.second = true;
-          }
-          if (!info.policy.canShrinkVertically() && box.h() > info.hint.h()) {
-            usable.second = true;
-          }
-        }
+      std::vector<std::uint8_t> horizontal(count), vertical(count);
 
-        // Check for growing.
-        if (action.canExtendHorizontally()) {
-          // The action requires to shrink: the item can do that if
-          // its policy is set to `Shrink` and the current size is
-          // larger than the `min` or if the policy is NOT set with
-          // the `Shrink` flag, the `hint` replaces the value.
-          if (info.policy.canExtendHorizontally() && box.w() < info.max.w()) {
-            usable.first = true;
-          }
-          if (!info.policy.canExtendHorizontally() && box.w() < info.hint.w()) {
-            usable.first = true;
-          }
-        }
-        if (action.canExtendVertically()) {
-          // The action requires to shrink: the item can do that if
-          // its policy is set to `Shrink` and the current size is
-          // larger than the `min` or if the policy is NOT set with
-          // the `Shrink` flag, the `hint` replaces the value.
-          if (info.policy.canExtendVertically() && box.h() < info.max.h()) {
-            usable.second = true;
-          }
-          if (!info.policy.canExtendVertically() && box.h() < info.hint.h()) {
-            usable.second = true;
-          }
-        }
+      layout::usableAxis(info.horizontal, actions.first, horizontal.data());
+      layout::usableAxis(info.vertical, actions.second, vertical.data());
+
+      std::vector<std::pair<bool, bool>> usable(count);
+      for (unsigned id = 0u ; id < count ; ++id) {
+        usable[id] = std::make_pair(horizontal[id] != 0u, vertical[id] != 0u);
       }
 
-      // If at this point the `usable` pair is still uniformly `false`,
-      // we can deduce that:
-      // 1) We don't have a valid hint but the item can neither shrink
-      //    nor grow to match the desired size.
-      // 2) We have a valid hint but the item can neither shrink nor
-      //    grow to match the desired size.
-      // It seems like we have a fixed size item: thus there's no way
-      // the item can be used to perform the desired `action`.
-      // In any case the default values are correct so we can just return
-      // the status.
       return usable;
     }
 
+    void
+    Layout::appendItem(ItemsInfo& info,
+                       const SizePolicy& policy,
+                       const utils::Sizef& min,
+                       const utils::Sizef& hint,
+                       const utils::Sizef& max,
+                       const utils::Boxf& area,
+                       bool visible) noexcept
+    {
+      const bool hintValid = hint.isValid();
+
+      info.horizontal.current.push_back(area.w());
+      info.horizontal.min.push_back(min.w());
+      info.horizontal.hint.push_back(hint.w());
+      info.horizontal.max.push_back(max.w());
+      info.horizontal.flags.push_back(
+        layout::toConstraints(
+          hintValid,
+          policy.isFixedHorizontally(),
+          policy.canShrinkHorizontally(),
+          policy.canExtendHorizontally()
+        )
+      );
+
+      info.vertical.current.push_back(area.h());
+      info.vertical.min.push_back(min.h());
+      info.vertical.hint.push_back(hint.h());
+      info.vertical.max.push_back(max.h());
+      info.vertical.flags.push_back(
+        layout::toConstraints(
+          hintValid,
+          policy.isFixedVertically(),
+          policy.canShrinkVertically(),
+          policy.canExtendVertically()
+        )
+      );
+
+      info.visible.push_back(visible);
+    }
+
+    std::pair<std::uint32_t, std::uint32_t>
+    Layout::toActions(const SizePolicy& action) noexcept {
+      return std::make_pair(
+        layout::toConstraints(false, false, action.canShrinkHorizontally(), action.canExtendHorizontally()),
+        layout::toConstraints(false, false, action.canShrinkVertically(), action.canExtendVertically())
+      );
+    }
+
   }
 }
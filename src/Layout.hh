@@ -1,13 +1,19 @@
 #ifndef    LAYOUT_HH
 # define   LAYOUT_HH
 
+# include <list>
 # include <memory>
 # include <vector>
+# include <cstddef>
+# include <unordered_map>
+# include <mutex>
 # include <maths_utils/Box.hh>
 # include <maths_utils/Size.hh>
 
 # include "LayoutItem.hh"
+# include "LayoutKernels.hh"
 # include "SizePolicy.hh"
+# include "SpatialIndex.hh"
 
 namespace sdl {
   namespace core {
@@ -196,8 +202,49 @@ namespace sdl {
         const LayoutItem*
         getItemAt(const utils::Vector2f& pos) const noexcept override;
 
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to provide the union of
+         *          the hit areas of the items managed by this layout. If any of the items is
+         *          not able to provide a valid hit area an invalid area is returned.
+         *          The area is expressed in the local frame of the container if any.
+         * @return - the area where any of the items of this layout can be hit.
+         */
+        utils::Boxf
+        getHitArea() const noexcept override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to also clear the cache
+         *          of the geometries computed by this layout: as this method is usually called
+         *          when some parameters of the layout changed, the cached results might not be
+         *          valid anymore.
+         */
+        void
+        invalidate() override;
+
+        /**
+         * @brief - Returns the number of geometry updates which could be served from the
+         *          cache of the results of `computeGeometry`.
+         * @return - the number of cache hits.
+         */
+        unsigned
+        getGeometryCacheHits() const noexcept;
+
+        /**
+         * @brief - Returns the number of geometry updates which required to call the
+         *          `computeGeometry` method.
+         * @return - the number of cache misses.
+         */
+        unsigned
+        getGeometryCacheMisses() const noexcept;
+
       protected:
 
+        /**
+         * @brief - The number of results of `computeGeometry` kept in the cache of the
+         *          layouts describing their parameters unless specified otherwise.
+         */
+        static constexpr unsigned DefaultGeometryCacheCapacity = 8u;
+
         /**
          * @brief - Builds a layout object with the specified name, parent widget
          *          and margin.
@@ -237,6 +284,37 @@ namespace sdl {
         void
         updatePrivate(const utils::Boxf& window) override;
 
+        /**
+         * @brief - Defines how many results of `computeGeometry` can be kept in the cache of
+         *          this layout. The results are indexed by the constraints of the items (size
+         *          policy, minimum, hint and maximum size) along with the available space and
+         *          the parameters provided by `describeGeometryInputs`. When an update matches
+         *          a cached entry the areas and visibility statuses are assigned again without
+         *          calling the `computeGeometry` method.
+         *          The cache is only used by layouts which describe their parameters through
+         *          `describeGeometryInputs`: for those it holds `DefaultGeometryCacheCapacity`
+         *          entries unless specified otherwise. A capacity of `0` disables it.
+         * @param capacity - the maximum number of entries in the cache.
+         */
+        void
+        setGeometryCacheCapacity(unsigned capacity);
+
+        /**
+         * @brief - Removes all the entries of the cache of results of `computeGeometry`.
+         */
+        void
+        clearGeometryCache() noexcept;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to propagate the
+         *          synchronous layout pass to the managed items: the areas computed by
+         *          `computeGeometry` are directly assigned to the items rather than
+         *          through `ResizeEvent`s.
+         * @param area - the new area of the layout.
+         */
+        void
+        layoutSynchronously(const utils::Boxf& area) override;
+
         /**
          * @brief - Interface method called by the `updatePrivate` method which is
          *          triggered after the size of this layout has been updated and
@@ -249,6 +327,24 @@ namespace sdl {
         virtual void
         computeGeometry(const utils::Boxf& window) = 0;
 
+        /**
+         * @brief - Used by inheriting classes to describe the parameters which influence the
+         *          result of `computeGeometry` on top of the constraints of the items, the
+         *          margin and the available space (e.g. the spacing or the direction). The
+         *          values are appended to `inputs` and become part of the key of the cache
+         *          of geometries.
+         *          The visibility of the items is not part of the key as layouts may assign
+         *          it themselves: layouts whose result depends on it should describe it here.
+         *          Returning `false` indicates that the results of `computeGeometry` can not
+         *          be cached, which is what the default implementation does. Layouts should
+         *          only return `true` if their `computeGeometry` has no side effects other
+         *          than calling `assignRenderingAreas` and `assignVisibilityStatus`.
+         * @param inputs - the list of parameters to complete.
+         * @return - `true` if the results of `computeGeometry` can be cached.
+         */
+        virtual bool
+        describeGeometryInputs(std::vector<float>& inputs) const;
+
         /**
          * @brief - Reimplementation of the base `LayoutItem` method. A layout item is
          *          not meant to process keyboard events which will be reflected in the
@@ -301,7 +397,19 @@ namespace sdl {
          */
         bool
         filterKeyboardEvents(const engine::EngineObject* watched,
-                             const engine::KeyEventShPtr e) const noexcept override;
+                             const engine::KeyEvent& e) const noexcept override;
+
+        using LayoutItem::filterKeyboardEvents;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method. The target of mouse
+         *          events is resolved by the widget containing this layout if any so that
+         *          the hit test is performed once for the whole hierarchy.
+         * @param pos - the position of the mouse event.
+         * @return - the item which should receive the event.
+         */
+        const LayoutItem*
+        resolveMouseTarget(const utils::Vector2f& pos) const noexcept override;
 
         /**
          * @brief - Redefintion of the base `EngineObject` method which allows to
@@ -409,6 +517,44 @@ namespace sdl {
         bool
         isValidIndex(int id) const noexcept;
 
+        /**
+         * @brief - Retrieves the items of this layout sorted by ascending order of their `z`
+         *          order key. Items with the same key are kept in insertion order. The result
+         *          is cached along with the geometry epoch at which it was computed and only
+         *          sorted again when the stacking order or the items changed.
+         *          This is only meant to be called while processing events.
+         * @return - the items sorted by ascending `z` order key.
+         */
+        const std::vector<std::pair<ZOrderKey, LayoutItem*>>&
+        getPaintOrder() const;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to queue the input item
+         *          for a refresh of its entry in the spatial index of this layout. The manager
+         *          of this layout is notified in turn.
+         * @param item - the item which changed.
+         */
+        void
+        itemHitAreaChanged(const LayoutItem& item) override;
+
+        /**
+         * @brief - Used to refresh the entries of the spatial index for the items queued
+         *          through `itemHitAreaChanged`. The priority of each item is defined by its
+         *          `z` order key and its insertion order so that the top most items are
+         *          visited first. Hidden items are removed from the index.
+         *          Assumes that the `m_hitIndexLocker` is already acquired.
+         */
+        void
+        refreshHitIndex() const;
+
+        /**
+         * @brief - Removes the input item from the spatial index and from the queue of the
+         *          items to refresh. Assumes that the `m_hitIndexLocker` is already acquired.
+         * @param item - the item to remove.
+         */
+        void
+        removeFromHitIndex(const LayoutItem* item);
+
         virtual utils::Sizef
         computeAvailableSize(const utils::Boxf& totalArea) const noexcept;
 
@@ -482,8 +628,161 @@ namespace sdl {
                     const utils::Boxf& box,
                     const SizePolicy& action) const;
 
+        /**
+         * @brief - Arrays representation of the information about the items of the layout:
+         *          this allows to process all the items at once which is faster for layouts
+         *          with many items than using the `WidgetInfo` structure.
+         */
+        struct ItemsInfo {
+          layout::AxisInfo horizontal;
+          layout::AxisInfo vertical;
+          std::vector<bool> visible;
+        };
+
+        /**
+         * @brief - Similar to `computeItemsInfo` but produces the arrays representation of the
+         *          information of the items.
+         * @return - the information about the items of the layout.
+         */
+        ItemsInfo
+        computeItemsArrays() const noexcept;
+
+        /**
+         * @brief - Converts the input information into an arrays representation. The current
+         *          size of each item is taken from its `area`.
+         * @param info - the information to convert.
+         * @return - the arrays representation of the input information.
+         */
+        static
+        ItemsInfo
+        computeItemsArrays(const std::vector<WidgetInfo>& info) noexcept;
+
+        /**
+         * @brief - Equivalent to calling `computeSizeFromPolicy` for each item described by the
+         *          input `info` with its current size and the corresponding delta.
+         * @param info - the information about the items.
+         * @param deltas - the size delta to apply to each item. Should have the same size as the
+         *                 number of items in `info`.
+         * @return - the size of each item after applying the delta and its constraints.
+         */
+        std::vector<utils::Sizef>
+        computeSizesFromPolicy(const ItemsInfo& info,
+                               const std::vector<utils::Sizef>& deltas) const;
+
+        /**
+         * @brief - Equivalent to calling `canBeUsedTo` for each item described by the input
+         *          `info` with its current size.
+         * @param info - the information about the items.
+         * @param action - the action to perform, as returned by `shrinkOrGrow`.
+         * @return - for each item whether it can be used to perform the horizontal and vertical
+         *           part of the `action`.
+         */
+        std::vector<std::pair<bool, bool>>
+        canBeUsedTo(const ItemsInfo& info,
+                    const SizePolicy& action) const;
+
       private:
 
+        /**
+         * @brief - Describes a call to either `assignRenderingAreas` or to the method called
+         *          `assignVisibilityStatus` performed by `computeGeometry`: these are recorded
+         *          so that they can be replayed in the same order.
+         */
+        struct Assignment {
+          bool visibility;
+          std::vector<utils::Boxf> boxes;
+          utils::Boxf window;
+          std::vector<bool> visible;
+        };
+
+        /**
+         * @brief - Describes a result of `computeGeometry` along with the inputs which were
+         *          used to produce it. The `hash` is computed from the other inputs and used
+         *          to speed up the comparison of the keys.
+         */
+        struct GeometryRecord {
+          std::size_t hash;
+          utils::Boxf window;
+          utils::Sizef margin;
+          BoxesFormat format;
+          Nesting nesting;
+          std::vector<WidgetInfo> items;
+          std::vector<float> parameters;
+          std::vector<Assignment> assignments;
+        };
+
+        /**
+         * @brief - Fills the input record with the current inputs of `computeGeometry` for
+         *          the specified `window`. The list of assignments is cleared. The storage
+         *          of the record is reused so that no allocation is needed when the number
+         *          of items did not change.
+         * @param window - the available space for the layout.
+         * @param record - the record to fill with the inputs of the computation.
+         * @return - `false` if the layout does not describe its parameters, in which case
+         *           the result of the computation can not be cached.
+         */
+        bool
+        buildGeometryRecord(const utils::Boxf& window,
+                            GeometryRecord& record) const;
+
+        /**
+         * @brief - Used to determine whether both records describe the same inputs of the
+         *          `computeGeometry` method. The rendering areas of the items are ignored.
+         * @param lhs - the first record to compare.
+         * @param rhs - the second record to compare.
+         * @return - `true` if both records have the same inputs.
+         */
+        static
+        bool
+        hasSameInputs(const GeometryRecord& lhs,
+                      const GeometryRecord& rhs) noexcept;
+
+        /**
+         * @brief - Runs `computeGeometry` for the specified `window` or replays the result
+         *          registered in the cache if the inputs did not change.
+         * @param window - the available space for the layout.
+         */
+        void
+        computeGeometryOrReplay(const utils::Boxf& window);
+
+        /**
+         * @brief - Applies the modifications registered in the current geometry transaction
+         *          to the items and posts a single repaint event to the container for all
+         *          the regions affected by these modifications.
+         */
+        void
+        commitTransaction();
+
+        /**
+         * @brief - Appends the description of an item to the arrays of `info`.
+         * @param info - the arrays to which the item should be appended.
+         * @param policy - the size policy of the item.
+         * @param min - the minimum size of the item.
+         * @param hint - the size hint of the item.
+         * @param max - the maximum size of the item.
+         * @param area - the current area of the item.
+         * @param visible - the visibility status of the item.
+         */
+        static
+        void
+        appendItem(ItemsInfo& info,
+                   const SizePolicy& policy,
+                   const utils::Sizef& min,
+                   const utils::Sizef& hint,
+                   const utils::Sizef& max,
+                   const utils::Boxf& area,
+                   bool visible) noexcept;
+
+        /**
+         * @brief - Converts the horizontal and vertical parts of the input `action` into a
+         *          combination of the `layout::Constraint::Shrink` and `Extend` bits.
+         * @param action - the action to convert.
+         * @return - the bits describing the horizontal and vertical parts of the action.
+         */
+        static
+        std::pair<std::uint32_t, std::uint32_t>
+        toActions(const SizePolicy& action) noexcept;
+
         /// Used to give access to `SdlWidget` to protected method on this class.
         friend class SdlWidget;
 
@@ -494,12 +793,33 @@ namespace sdl {
          */
         using Items = std::vector<LayoutItem*>;
 
+        /**
+         * @brief - Describes an item along with the order in which it was inserted in the
+         *          layout. This order is used to sort items with the same `z` order key.
+         */
+        struct IndexedItem {
+          const LayoutItem* item;
+          unsigned order;
+        };
+
+        using ItemsIndex = std::unordered_map<const engine::EngineObject*, IndexedItem>;
+
         /**
          * @brief - Contains the list of all the managed items by this layout. Items
          *          are inserted in a chronological order into this array.
          */
         Items        m_items;
 
+        /**
+         * @brief - Allows to determine whether an object is managed by this layout without
+         *          traversing the `m_items`. This is used to filter events, where the object
+         *          which is watched is only known as an `EngineObject`. The counter holds the
+         *          insertion order of the next item.
+         *          Modifications are protected by the `m_hitIndexLocker`.
+         */
+        ItemsIndex m_itemsIndex;
+        unsigned m_itemsOrder;
+
         /**
          * @brief - Margin to use when computing the size available for children widgets. Basically
          *          when given an available space to allocate between widgets, we subtract first the
@@ -522,6 +842,70 @@ namespace sdl {
          *          top of its layout hiearchy and is strongly tied to the `m_boxesFormat` attribute.
          */
         Nesting      m_nesting;
+
+        /**
+         * @brief - Spatial index of the items of this layout based on their hit area. The
+         *          entries of the items are updated individually when they are notified
+         *          through `itemHitAreaChanged`. Protected by the `m_hitIndexLocker`.
+         */
+        mutable SpatialIndex<const LayoutItem*, std::pair<ZOrderKey, unsigned>> m_hitIndex;
+        mutable std::mutex m_hitIndexLocker;
+
+        /**
+         * @brief - The items whose entry in the spatial index should be refreshed before the
+         *          next query. The queue is protected by its own lock which is never held while
+         *          acquiring another one so that items can notify the layout from any context.
+         *          The refresh buffer is only used to process the queue and is protected by the
+         *          `m_hitIndexLocker`.
+         */
+        mutable std::vector<const LayoutItem*> m_hitUpdates;
+        mutable std::vector<const LayoutItem*> m_hitRefresh;
+        mutable std::mutex m_hitUpdatesLocker;
+
+        /**
+         * @brief - Indicates whether a synchronous layout pass is running for this layout:
+         *          in this case the areas are assigned to the items right away instead of
+         *          being posted as events.
+         */
+        bool m_synchronous;
+
+        /**
+         * @brief - Cache of the results of `computeGeometry` sorted from the most recently
+         *          used to the least recently used. The capacity defines how many records
+         *          can be kept at most.
+         *          While `computeGeometry` runs the assignments are recorded in the record
+         *          pointed at by `m_recording` (which is `null` otherwise).
+         *          The `m_geometryKey` holds the inputs of the current update: it is kept
+         *          from one update to the next to reuse its storage.
+         */
+        std::list<GeometryRecord> m_geometryCache;
+        unsigned m_geometryCacheCapacity;
+        GeometryRecord* m_recording;
+        GeometryRecord m_geometryKey;
+
+        /**
+         * @brief - Statistics about the use of the cache of geometries.
+         */
+        unsigned m_geometryCacheHits;
+        unsigned m_geometryCacheMisses;
+
+        /**
+         * @brief - The widget containing this layout if any. When it is known, the areas and
+         *          visibility statuses computed during an update are registered in a geometry
+         *          transaction (one entry per item) and applied in a single step at the end of
+         *          the update instead of being posted as events to each item. The container
+         *          then receives a single repaint event.
+         */
+        SdlWidget* m_container;
+        bool m_batching;
+        std::vector<GeometryChange> m_transaction;
+
+        /**
+         * @brief - The items sorted by ascending `z` order key as returned by `getPaintOrder`
+         *          along with the geometry epoch at which they were sorted.
+         */
+        mutable std::vector<std::pair<ZOrderKey, LayoutItem*>> m_paintOrder;
+        mutable unsigned m_paintOrderEpoch;
     };
 
     using LayoutShPtr = std::shared_ptr<Layout>;
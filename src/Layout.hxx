@@ -78,7 +78,17 @@ namespace sdl {
       }
 
       // Remove the item.
+      {
+        const std::lock_guard guard(m_hitIndexLocker);
+        m_itemsIndex.erase(m_items[physID]);
+        removeFromHitIndex(m_items[physID]);
+      }
       m_items.erase(m_items.cbegin() + physID);
+      clearGeometryCache();
+
+      // The hit targets memorized by the items are not valid anymore.
+      invalidateGeometryEpoch();
+      hitAreaChanged();
 
       // Trigger a call to the notifier method.
       const bool rebuild = onIndexRemoved(item, physID);
@@ -129,6 +139,48 @@ namespace sdl {
       updatePrivate(window);
     }
 
+    inline
+    void
+    Layout::invalidate() {
+      clearGeometryCache();
+      LayoutItem::invalidate();
+    }
+
+    inline
+    unsigned
+    Layout::getGeometryCacheHits() const noexcept {
+      return m_geometryCacheHits;
+    }
+
+    inline
+    unsigned
+    Layout::getGeometryCacheMisses() const noexcept {
+      return m_geometryCacheMisses;
+    }
+
+    inline
+    void
+    Layout::setGeometryCacheCapacity(unsigned capacity) {
+      m_geometryCacheCapacity = capacity;
+
+      while (m_geometryCache.size() > m_geometryCacheCapacity) {
+        m_geometryCache.pop_back();
+      }
+    }
+
+    inline
+    void
+    Layout::clearGeometryCache() noexcept {
+      m_geometryCache.clear();
+    }
+
+    inline
+    bool
+    Layout::describeGeometryInputs(std::vector<float>& /*inputs*/) const {
+      // The parameters of the layout are unknown: the results can't be cached.
+      return false;
+    }
+
     inline
     void
     Layout::setEventsQueue(engine::EventsQueue* queue) noexcept {
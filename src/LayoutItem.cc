@@ -1,9 +1,22 @@
 
 # include "LayoutItem.hh"
+# include <atomic>
+# include <algorithm>
+# include <new>
 
 namespace sdl {
   namespace core {
 
+    namespace {
+
+      /**
+       * @brief - The geometry epoch shared by all layout items. Starts at `1` so that
+       *          caches can use `0` as an invalid value.
+       */
+      std::atomic_uint geometryEpoch(1u);
+
+    }
+
     LayoutItem::LayoutItem(const std::string& name,
                            const utils::Sizef& sizeHint):
       engine::EngineObject(name),
@@ -16,6 +29,9 @@ namespace sdl {
       m_focusPolicy(),
 
       m_geometryDirty(true),
+      m_geometryUpdatePending(false),
+      m_suppressedGeometryUpdates(0u),
+      m_geometryPass(GeometryPass::Queued),
       m_area(),
 
       m_visible(true),
@@ -26,7 +42,10 @@ namespace sdl {
       m_zOrder(0),
       m_keyboardFocus(false),
 
-      m_manager(nullptr)
+      m_manager(nullptr),
+      m_hitAreaPending(false),
+
+      m_hitTargets(nullptr)
     {
       setService(std::string("layout_item"));
 
@@ -36,9 +55,75 @@ namespace sdl {
       activateEventsProcessing();
     }
 
+    const LayoutItem*
+    LayoutItem::resolveMouseTarget(const utils::Vector2f& pos) const noexcept {
+      HitTargets* hits = getHitTargets();
+
+      // Without a memo we can only perform the hit test.
+      if (hits == nullptr) {
+        return getItemAt(pos);
+      }
+
+      const unsigned epoch = getGeometryEpoch();
+
+      {
+        const std::lock_guard guard(hits->locker);
+
+        if (hits->epoch != epoch) {
+          hits->count = 0u;
+          hits->next = 0u;
+          hits->epoch = epoch;
+        }
+
+        for (unsigned id = 0u ; id < hits->count ; ++id) {
+          if (hits->targets[id].position == pos) {
+            return hits->targets[id].item;
+          }
+        }
+      }
+
+      // Perform the hit test without holding the lock: the children of
+      // this item might be locked in the process.
+      const LayoutItem* target = getItemAt(pos);
+
+      const std::lock_guard guard(hits->locker);
+
+      // Only register the result if the geometry did not change in the
+      // meantime.
+      if (hits->epoch == epoch) {
+        hits->targets[hits->next] = HitTarget{pos, target};
+        hits->next = (hits->next + 1u) % hits->targets.size();
+        hits->count = std::min<unsigned>(hits->count + 1u, hits->targets.size());
+      }
+
+      return target;
+    }
+
+    LayoutItem::HitTargets*
+    LayoutItem::getHitTargets() const noexcept {
+      HitTargets* hits = m_hitTargets.load(std::memory_order_acquire);
+      if (hits != nullptr) {
+        return hits;
+      }
+
+      HitTargets* created = new (std::nothrow) HitTargets{{}, 0u, 0u, 0u, {}};
+      if (created == nullptr) {
+        return nullptr;
+      }
+
+      // Another thread might have allocated the targets in the meantime: in
+      // this case we use its version.
+      if (!m_hitTargets.compare_exchange_strong(hits, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        delete created;
+        return hits;
+      }
+
+      return created;
+    }
+
     bool
     LayoutItem::filterMouseEvents(const engine::EngineObject* watched,
-                                  const engine::MouseEventShPtr e) const noexcept
+                                  const engine::MouseEvent& e) const noexcept
     {
       // What is important here is to detect mouse events which should be send to
       // another object than `watched`. This can happen if one of the other items
@@ -57,7 +142,7 @@ namespace sdl {
       // happen for all but the mouse wheel event where there's no real meaning of
       // position.
       // Let's handle this first and move on to building the list.
-      if (e->getType() == engine::Event::Type::MouseWheel) {
+      if (e.getType() == engine::Event::Type::MouseWheel) {
         // No filtering performed at this step.
         return false;
       }
@@ -65,9 +150,9 @@ namespace sdl {
       // Retrieve the item at this position: either it corresponds to the input object
       // in which case it means that given all the registered item the provided one is
       // the most relevant one to pass the event to so we don't filter it. Otherwise
-      // we have to filter the event so that probably the item returned by `getItemAt`
-      // method gets it.
-      const LayoutItem* bestFit = getItemAt(e->getMousePosition());
+      // we have to filter the event so that probably the item returned by the
+      // `resolveMouseTarget` method gets it.
+      const LayoutItem* bestFit = resolveMouseTarget(e.getMousePosition());
       if (bestFit == nullptr) {
         return true;
       }
@@ -80,18 +165,18 @@ namespace sdl {
       // mouse. We might still be okay in the case of drag events, where we want to
       // transmit the events to the items where the event started.
 
-      if (e->getType() != engine::Event::Type::MouseDrag) {
+      if (e.getType() != engine::Event::Type::MouseDrag) {
         // Not a drag event, we're done, the event should be filtered.
         return true;
       }
 
       // Check whether the `watched` event was located where any of the drag motion
       // started (i.e. any of the button).
-      engine::mouse::Buttons bs = e->getButtons();
+      engine::mouse::Buttons bs = e.getButtons();
 
       engine::mouse::Button b = engine::mouse::Button::Left;
       if (bs.isSet(b)) {
-        const LayoutItem* best = getItemAt(e->getInitMousePosition(b));
+        const LayoutItem* best = resolveMouseTarget(e.getInitMousePosition(b));
 
         // The item is located where the button started to be dragged, this is enough
         // to send it this event.
@@ -102,7 +187,7 @@ namespace sdl {
 
       b = engine::mouse::Button::Middle;
       if (bs.isSet(b)) {
-        const LayoutItem* best = getItemAt(e->getInitMousePosition(b));
+        const LayoutItem* best = resolveMouseTarget(e.getInitMousePosition(b));
 
         if (best == watched) {
           return false;
@@ -111,7 +196,7 @@ namespace sdl {
 
       b = engine::mouse::Button::Right;
       if (bs.isSet(b)) {
-        const LayoutItem* best = getItemAt(e->getInitMousePosition(b));
+        const LayoutItem* best = resolveMouseTarget(e.getInitMousePosition(b));
 
         if (best == watched) {
           return false;
@@ -125,7 +210,7 @@ namespace sdl {
 
     bool
     LayoutItem::filterDragAndDropEvents(const engine::EngineObject* watched,
-                                        const engine::DropEventShPtr e) const noexcept
+                                        const engine::DropEvent& e) const noexcept
     {
       // A drag and drop events usually include moving the mouse from a position to
       // another while keeping one or several buttons pressed. Elements might want
@@ -141,8 +226,8 @@ namespace sdl {
 
       // Retrieve the best fit for both the start position of the drag and drop operation
       // and also for the end of it.
-      const LayoutItem* bestFitForStart = getItemAt(e->getStartPosition());
-      const LayoutItem* bestFitForStop = getItemAt(e->getEndPosition());
+      const LayoutItem* bestFitForStart = resolveMouseTarget(e.getStartPosition());
+      const LayoutItem* bestFitForStop = resolveMouseTarget(e.getEndPosition());
 
       // The event is filtered if the input `watched` object is neither the start or the
       // destination of the event.
@@ -151,6 +236,10 @@ namespace sdl {
 
     bool
     LayoutItem::geometryUpdateEvent(const engine::Event& e) {
+      // The pending event is being processed: any subsequent invalidation
+      // should post a new one.
+      m_geometryUpdatePending = false;
+
       // Perform the rebuild if the geometry has changed.
       // This check should not be really useful because
       // the `geometryUpdateEvent` should already be
@@ -178,9 +267,9 @@ namespace sdl {
       }
 
       // Assign the area.
-      m_area = e.getNewSize();
+      assignArea(e.getNewSize());
 
-      info(std::string("Area is now ") + m_area.toString());
+      lazyLog<LogLevel::Info>([&]() { return std::string("Area is now ") + m_area.toString(); });
 
       // Once the internal size has been updated, we need to both recompute
       // the geometry and then perform a repaint. Post both events.
@@ -190,5 +279,164 @@ namespace sdl {
       return engine::EngineObject::resizeEvent(e);
     }
 
+    void
+    LayoutItem::layoutSynchronously(const utils::Boxf& area) {
+      // Dispatch the resize to the handler so that inheriting classes
+      // get notified exactly as with a posted event.
+      engine::ResizeEvent e(area, m_area, this);
+
+      const GeometryPass previous = m_geometryPass;
+      m_geometryPass = GeometryPass::Synchronous;
+
+      try {
+        resizeEvent(e);
+      }
+      catch (...) {
+        m_geometryPass = previous;
+        throw;
+      }
+
+      m_geometryPass = previous;
+
+      // Recompute the geometry right away: any pending geometry update
+      // event will not have anything left to do.
+      updatePrivate(m_area);
+      geometryRecomputed();
+    }
+
+    bool
+    LayoutItem::assignArea(const utils::Boxf& area) {
+      if (area == m_area) {
+        return false;
+      }
+
+      m_area = area;
+
+      // Any cache computed from the geometry of the items is now invalid.
+      invalidateGeometryEpoch();
+      areaChanged();
+      hitAreaChanged();
+
+      return true;
+    }
+
+    std::vector<utils::Boxf>
+    LayoutItem::commitGeometry(const GeometryChange& change) {
+      // Dispatch the modifications to the handlers in place: inheriting
+      // classes get notified just as if the events had been posted.
+      const GeometryPass previous = m_geometryPass;
+      m_geometryPass = GeometryPass::Committed;
+
+      try {
+        if (change.resized) {
+          engine::ResizeEvent e(change.area, m_area, this);
+          resizeEvent(e);
+        }
+
+        if (change.toggled && change.visible) {
+          engine::Event e(engine::Event::Type::Show, this);
+          e.setEmitter(this);
+          showEvent(e);
+        }
+
+        if (change.toggled && !change.visible) {
+          engine::HideEvent e(LayoutItem::getDrawingArea(), this);
+          e.setEmitter(this);
+          hideEvent(e);
+        }
+      }
+      catch (...) {
+        m_geometryPass = previous;
+        throw;
+      }
+
+      m_geometryPass = previous;
+
+      // Nothing to repaint for a generic item.
+      return std::vector<utils::Boxf>();
+    }
+
+    bool
+    LayoutItem::assignVisibility(bool visible) {
+      bool changed = false;
+      {
+        const std::lock_guard guard(m_visibleLocker);
+        changed = (m_visible != visible);
+        m_visible = visible;
+      }
+
+      // Activate or deactivate the events for this item only if we actually
+      // changed the internal status of the item.
+      if (!changed) {
+        return false;
+      }
+
+      // Items which are hidden cannot be hit anymore.
+      invalidateGeometryEpoch();
+      hitAreaChanged();
+
+      if (!visible) {
+        disableEventsProcessing();
+        return true;
+      }
+
+      activateEventsProcessing();
+
+      // The pending geometry update might have been discarded while the
+      // item was hidden: post a new one if the geometry is still dirty.
+      if (m_geometryDirty) {
+        m_geometryUpdatePending = false;
+        makeGeometryDirty();
+      }
+
+      return true;
+    }
+
+    void
+    LayoutItem::areaChanged() {
+      // Nothing to do, generic items do not derive anything from their area.
+    }
+
+    void
+    LayoutItem::focusPolicyChanged() noexcept {
+      // Nothing to do, generic items do not derive anything from their policy.
+    }
+
+    void
+    LayoutItem::hitAreaChanged() {
+      // Top level items are indexed by their manager.
+      if (m_manager != nullptr) {
+        m_manager->itemHitAreaChanged(*this);
+      }
+    }
+
+    void
+    LayoutItem::itemHitAreaChanged(const LayoutItem& /*item*/) {
+      // Nothing to do, generic items do not index any item.
+    }
+
+    bool
+    LayoutItem::markHitAreaPending(const LayoutItem& item,
+                                   bool pending) noexcept
+    {
+      const bool previous = item.m_hitAreaPending;
+      item.m_hitAreaPending = pending;
+
+      return previous;
+    }
+
+    unsigned
+    LayoutItem::getGeometryEpoch() noexcept {
+      return geometryEpoch.load();
+    }
+
+    void
+    LayoutItem::invalidateGeometryEpoch() noexcept {
+      // Skip the `0` value when wrapping around.
+      if (++geometryEpoch == 0u) {
+        ++geometryEpoch;
+      }
+    }
+
   }
 }
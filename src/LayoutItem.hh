@@ -1,8 +1,11 @@
 #ifndef    LAYOUT_ITEM_HH
 # define   LAYOUT_ITEM_HH
 
+# include <array>
 # include <mutex>
+# include <atomic>
 # include <memory>
+# include <vector>
 # include <maths_utils/Box.hh>
 # include <maths_utils/Size.hh>
 # include <sdl_engine/EngineObject.hh>
@@ -13,6 +16,9 @@
 # include "SizePolicy.hh"
 # include "FocusPolicy.hh"
 # include "FocusState.hh"
+# include "ZOrderKey.hh"
+# include "LogLevel.hh"
+# include "EventsPool.hh"
 
 namespace sdl {
   namespace core {
@@ -134,8 +140,9 @@ namespace sdl {
          *          `          + Item 3    2      `
          *          A call to this method like `getZOrderString` will return "102" while
          *          a call like `getZOrderString(Item 2)` will return "02".
-         *          This is particularly useful to sort and compare items which are not
-         *          part of the exact same parent.
+         *          This is only meant for debugging purposes: to sort and compare items
+         *          which are not part of the exact same parent one should rather use the
+         *          `getZOrderKey` method.
          *          Note that this method are encouraged to reimplement this method as
          *          this one is exactly similar to the `getZOrder` one, except it returns
          *          a string rather than an integer.
@@ -148,6 +155,19 @@ namespace sdl {
         virtual std::string
         getZOrderString(const LayoutItem* stop = nullptr) const noexcept;
 
+        /**
+         * @brief - Returns a key describing the successive `z` orders of this item and its
+         *          parents starting with the top most ancestor. Comparing the keys of two
+         *          items allows to determine which one is displayed on top of the other
+         *          even if they do not belong to the same parent.
+         *          Inheriting classes are encouraged to reimplement this method when they
+         *          have a notion of parent: the default implementation only accounts for
+         *          the `z` order of this item.
+         * @return - a key describing the `z` order of this item in the hierarchy.
+         */
+        virtual ZOrderKey
+        getZOrderKey() const noexcept;
+
         /**
          * @brief - Assigns a new z order for this item. A new `ZOrderChanged` event will
          *          be issued and directed towards this item.
@@ -219,6 +239,14 @@ namespace sdl {
         virtual void
         invalidate();
 
+        /**
+         * @brief - Returns the number of calls to `makeGeometryDirty` which did not post a
+         *          new `GeometryUpdate` event because one was already pending for this item.
+         * @return - the number of suppressed geometry updates.
+         */
+        unsigned
+        getSuppressedGeometryUpdatesCount() const noexcept;
+
         /**
          * @brief - Reimplementation of the base `EngineObject` method. This allows to first
          *          separate filtering on mouse event, keyboard event, and some other kind of
@@ -250,8 +278,121 @@ namespace sdl {
         virtual const LayoutItem*
         getItemAt(const utils::Vector2f& pos) const noexcept = 0;
 
+        /**
+         * @brief - Retrieves the area where the `getItemAt` method can return a valid item
+         *          for this layout item, expressed in the coordinate frame of the element
+         *          indexing this item: the local frame of the parent widget for children
+         *          widgets and the frame of the manager layout for other items. This is
+         *          used to index items for hit testing purposes.
+         *          The default implementation returns an invalid area which indicates that
+         *          the item should be considered for any position. Inheriting classes are
+         *          encouraged to specialize this method to return tighter bounds and to
+         *          call `hitAreaChanged` whenever the returned value is modified.
+         * @return - the area where the item or any of its children can be hit, or an invalid
+         *           area if it is not known.
+         */
+        virtual utils::Boxf
+        getHitArea() const noexcept;
+
+        /**
+         * @brief - Used to determine whether this item completely covers its rendering area
+         *          when displayed. Opaque items hide whatever lies below them: items with a
+         *          lower z order which are entirely covered by opaque siblings do not need to
+         *          be repainted.
+         *          The default implementation returns `false` which is always safe.
+         * @return - `true` if this item is opaque.
+         */
+        virtual bool
+        isOpaque() const noexcept;
+
       protected:
 
+        /**
+         * @brief - Retrieves the current value of the geometry epoch. This value is shared by
+         *          all the layout items and is incremented each time the area, the visibility,
+         *          the stacking order or the hierarchy of any item is modified. Caches derived from these
+         *          properties can store the epoch at which they were computed and compare it
+         *          with the current value to detect that they need to be refreshed.
+         *          Note that a value of `0` is never returned and can be used to indicate an
+         *          invalid cache.
+         * @return - the current geometry epoch.
+         */
+        static
+        unsigned
+        getGeometryEpoch() noexcept;
+
+        /**
+         * @brief - Increments the geometry epoch which invalidates all the caches computed
+         *          from the geometry of the items.
+         */
+        static
+        void
+        invalidateGeometryEpoch() noexcept;
+
+        /**
+         * @brief - Called by `assignArea` when the area of this item is modified. Inheriting
+         *          classes can specialize this method to refresh the values they derive from
+         *          the position of the item. The default implementation does nothing.
+         */
+        virtual void
+        areaChanged();
+
+        /**
+         * @brief - Called by `setFocusPolicy` when the focus policy of this item is modified.
+         *          Inheriting classes can specialize this method to refresh the values they
+         *          derive from the policy, such as the order in which items are cycled through
+         *          using the `Tab` key. The default implementation does nothing.
+         */
+        virtual void
+        focusPolicyChanged() noexcept;
+
+        /**
+         * @brief - Notifies the element indexing this item for hit testing purposes that
+         *          its hit area, its visibility or its stacking order changed. The default
+         *          implementation forwards the notification to the manager of this item if
+         *          any through `itemHitAreaChanged`.
+         *          This method only acquires locks dedicated to the notification and can be
+         *          called from any context.
+         */
+        virtual void
+        hitAreaChanged();
+
+        /**
+         * @brief - Called when the hit area, the visibility or the stacking order of an item
+         *          indexed by this item changed. The default implementation does nothing:
+         *          inheriting classes maintaining a spatial index of their items should use
+         *          it to refresh the entry of the item.
+         * @param item - the item which changed.
+         */
+        virtual void
+        itemHitAreaChanged(const LayoutItem& item);
+
+        /**
+         * @brief - Assigns the status indicating whether the input item is queued to refresh
+         *          its entry in the spatial index of the element indexing it. This status is
+         *          used to notify the element only once until the entry is refreshed, it is
+         *          expected to be protected by the lock of the queue.
+         * @param item - the item for which the status should be assigned.
+         * @param pending - the new status of the item.
+         * @return - the previous status of the item.
+         */
+        static
+        bool
+        markHitAreaPending(const LayoutItem& item,
+                           bool pending) noexcept;
+
+        /**
+         * @brief - Produces a log message with the specified level. The message is built
+         *          by calling the `builder` only if the level is enabled: this avoids the
+         *          cost of formatting messages which would be discarded anyway. Messages
+         *          with a level lower than `SDL_CORE_MIN_LOG_LEVEL` are removed at compile
+         *          time.
+         * @param builder - a callable returning the message to log as a string.
+         */
+        template <LogLevel Level, typename Builder>
+        void
+        lazyLog(Builder builder) const;
+
         /**
          * @brief - Reimplementation of the base `EngineObject` method. A layout item is
          *          not meant to process window events which will be reflected in the
@@ -315,6 +456,92 @@ namespace sdl {
         virtual void
         updatePrivate(const utils::Boxf& window);
 
+        /**
+         * @brief - Assigns the input area to this item and recomputes its geometry right
+         *          away instead of going through `ResizeEvent` and `GeometryUpdate` events.
+         *          This is used by layouts during a synchronous layout pass: the pass goes
+         *          through the whole hierarchy of nested layouts in a single call.
+         *          The default implementation dispatches a `ResizeEvent` built on the stack
+         *          to `resizeEvent` and then calls `updatePrivate`: specializations of the
+         *          handler are thus called just like for a regular resize.
+         * @param area - the new area of the item.
+         */
+        virtual void
+        layoutSynchronously(const utils::Boxf& area);
+
+        /**
+         * @brief - Assigns the input area as the rendering area of this item without
+         *          triggering any update of the geometry.
+         * @param area - the new area of the item.
+         * @return - `true` if the area was modified.
+         */
+        bool
+        assignArea(const utils::Boxf& area);
+
+        /**
+         * @brief - Used to determine whether the geometry handlers (`resizeEvent`, `showEvent`
+         *          and `hideEvent`) are currently called directly by a layout pass through
+         *          `layoutSynchronously` or `commitGeometry` rather than from the events queue.
+         *          In this case the pass takes care of the repaint of the item so handlers do
+         *          not need to post any event.
+         * @return - `true` if the handlers are called by a layout pass.
+         */
+        bool
+        isApplyingGeometry() const noexcept;
+
+        /**
+         * @brief - Describes the modifications of the geometry of an item computed by its
+         *          layout: the new area (if `resized` is `true`) and the new visibility
+         *          status (if `toggled` is `true`).
+         */
+        struct GeometryChange {
+          bool resized;
+          utils::Boxf area;
+          bool toggled;
+          bool visible;
+        };
+
+        /**
+         * @brief - Applies the modifications computed by the layout managing this item in a
+         *          single step rather than by posting `ResizeEvent`s and `Show`/`Hide` events.
+         *          The default implementation builds these events on the stack and dispatches
+         *          them right away to `resizeEvent`, `showEvent` and `hideEvent` so that their
+         *          specializations are still called.
+         *          Inheriting classes can return the regions (in global coordinate frame)
+         *          which need to be repainted by the container of the layout: these will be
+         *          merged with the ones of the other items of the layout.
+         * @param change - the modifications to apply to this item.
+         * @return - the regions to repaint in the container of the layout.
+         */
+        virtual std::vector<utils::Boxf>
+        commitGeometry(const GeometryChange& change);
+
+        /**
+         * @brief - Assigns the visibility status of this item and activates or disables the
+         *          processing of events accordingly.
+         * @param visible - the new visibility status.
+         * @return - `true` if the visibility status was modified.
+         */
+        bool
+        assignVisibility(bool visible);
+
+        /**
+         * @brief - Used to determine which item should receive a mouse event happening at the
+         *          specified position. This is used by `filterMouseEvents` and by the
+         *          `filterDragAndDropEvents` to decide whether an event should be transmitted
+         *          to the item it watches.
+         *          The default implementation returns the result of `getItemAt`, which is
+         *          memorized until the geometry epoch changes: all the filters applied to the
+         *          same event (and the several positions of a drag event) thus perform the
+         *          hit test only once. Inheriting classes can specialize it to resolve the
+         *          target once for all the items of a hierarchy.
+         * @param pos - the position of the mouse event.
+         * @return - the item which should receive the event or null if no item spans the
+         *           input position.
+         */
+        virtual const LayoutItem*
+        resolveMouseTarget(const utils::Vector2f& pos) const noexcept;
+
         /**
          * @brief - Provide a base interface for inheriting classes to be able to filter mouse
          *          events without need to cast anything. This method is called by the base
@@ -329,6 +556,20 @@ namespace sdl {
          * @return - `true` if this event should be filtered and `false` otherwise.
          */
         virtual bool
+        filterMouseEvents(const engine::EngineObject* watched,
+                          const engine::MouseEvent& e) const noexcept;
+
+        /**
+         * @brief - Overload of `filterMouseEvents` receiving the event through a shared
+         *          pointer, kept for the inheriting classes written against it: this is the
+         *          method called by `filterEvent`. The default implementation forwards the
+         *          event to the overload taking a reference, which new code should specialize
+         *          instead.
+         * @param watched - the element for which the event should be filtered.
+         * @param e - the event which should be filtered.
+         * @return - `true` if this event should be filtered and `false` otherwise.
+         */
+        virtual bool
         filterMouseEvents(const engine::EngineObject* watched,
                           const engine::MouseEventShPtr e) const noexcept;
 
@@ -346,6 +587,20 @@ namespace sdl {
          * @return - `true` if this event should be filtered and `false` otherwise.
          */
         virtual bool
+        filterKeyboardEvents(const engine::EngineObject* watched,
+                             const engine::KeyEvent& e) const noexcept;
+
+        /**
+         * @brief - Overload of `filterKeyboardEvents` receiving the event through a shared
+         *          pointer, kept for the inheriting classes written against it: this is the
+         *          method called by `filterEvent`. The default implementation forwards the
+         *          event to the overload taking a reference, which new code should specialize
+         *          instead.
+         * @param watched - the element for which the event should be filtered.
+         * @param e - the event which should be filtered.
+         * @return - `true` if this event should be filtered and `false` otherwise.
+         */
+        virtual bool
         filterKeyboardEvents(const engine::EngineObject* watched,
                              const engine::KeyEventShPtr e) const noexcept;
 
@@ -363,6 +618,20 @@ namespace sdl {
          * @return - `true` if this event should be filtered and `false` otherwise.
          */
         virtual bool
+        filterDragAndDropEvents(const engine::EngineObject* watched,
+                                const engine::DropEvent& e) const noexcept;
+
+        /**
+         * @brief - Overload of `filterDragAndDropEvents` receiving the event through a shared
+         *          pointer, kept for the inheriting classes written against it: this is the
+         *          method called by `filterEvent`. The default implementation forwards the
+         *          event to the overload taking a reference, which new code should specialize
+         *          instead.
+         * @param watched - the element for which the event should be filtered.
+         * @param e - the event which should be filtered.
+         * @return - `true` if this event should be filtered and `false` otherwise.
+         */
+        virtual bool
         filterDragAndDropEvents(const engine::EngineObject* watched,
                                 const engine::DropEventShPtr e) const noexcept;
 
@@ -412,6 +681,9 @@ namespace sdl {
 
       private:
 
+        /// Used to give access to `Layout` to the synchronous layout methods.
+        friend class Layout;
+
         /**
          * @brief - Describes the size policy for this item. The policy is described using
          *          several sizes which roles are described below. In addition to that, the
@@ -471,6 +743,29 @@ namespace sdl {
          */
         bool m_geometryDirty;
 
+        /**
+         * @brief - Indicates whether a `GeometryUpdate` event has been posted for this item
+         *          and not processed yet. This allows to post at most one such event no matter
+         *          how many times the geometry is invalidated before it is recomputed.
+         *          The counter keeps track of the number of events which were not posted.
+         */
+        std::atomic_bool m_geometryUpdatePending;
+        std::atomic_uint m_suppressedGeometryUpdates;
+
+        /**
+         * @brief - Describes how the geometry handlers of this item are currently called:
+         *          through the events queue or directly by a layout pass. A synchronous
+         *          pass recomputes the geometry right after the handler so there's no
+         *          need to post a `GeometryUpdate` event in this case.
+         */
+        enum class GeometryPass {
+          Queued,
+          Synchronous,
+          Committed
+        };
+
+        GeometryPass m_geometryPass;
+
         /**
          * @brief - Describes the current rendering area assigned to this item. Should always
          *          be greater than the `m_minSize`, smaller than the `m_maxSize` and as close
@@ -532,6 +827,51 @@ namespace sdl {
          *          this item has been inserted.
          */
         LayoutItem* m_manager;
+
+        /**
+         * @brief - Whether this item is queued for a refresh of its entry in the spatial index
+         *          of the element indexing it. See `markHitAreaPending`.
+         */
+        mutable bool m_hitAreaPending;
+
+        /**
+         * @brief - Describes the item resolved as the target of events happening at some
+         *          position.
+         */
+        struct HitTarget {
+          utils::Vector2f position;
+          const LayoutItem* item;
+        };
+
+        /**
+         * @brief - The last targets resolved by the `resolveMouseTarget` method along with
+         *          the geometry epoch at which they were computed. A drag event is tested
+         *          against the current position and the initial position of each button so
+         *          we keep a few of them and replace the oldest one when needed.
+         *          The `locker` protects the targets from concurrent accesses.
+         */
+        struct HitTargets {
+          std::array<HitTarget, 4u> targets;
+          unsigned count;
+          unsigned next;
+          unsigned epoch;
+          std::mutex locker;
+        };
+
+        /**
+         * @brief - Retrieves the hit targets of this item, allocating them on the first
+         *          call: only the roots of the hierarchies resolve mouse targets so other
+         *          items never pay for them.
+         * @return - the hit targets of this item or `null` if they could not be allocated.
+         */
+        HitTargets*
+        getHitTargets() const noexcept;
+
+        /**
+         * @brief - The hit targets of this item, allocated by `getHitTargets` and released
+         *          when the item is destroyed.
+         */
+        mutable std::atomic<HitTargets*> m_hitTargets;
     };
 
     using LayoutItemShPtr = std::shared_ptr<LayoutItem>;
@@ -7,7 +7,9 @@ namespace sdl {
   namespace core {
 
     inline
-    LayoutItem::~LayoutItem() {}
+    LayoutItem::~LayoutItem() {
+      delete m_hitTargets.load();
+    }
 
     inline
     utils::Sizef
@@ -83,6 +85,9 @@ namespace sdl {
     LayoutItem::setFocusPolicy(const FocusPolicy& policy) noexcept {
       if (policy != m_focusPolicy) {
         m_focusPolicy = policy;
+
+        // The items which can be cycled through with `Tab` might have changed.
+        focusPolicyChanged();
       }
     }
 
@@ -98,6 +103,51 @@ namespace sdl {
       return m_area;
     }
 
+    inline
+    utils::Boxf
+    LayoutItem::getHitArea() const noexcept {
+      // Unknown area, the item should always be considered.
+      return utils::Boxf();
+    }
+
+    template <LogLevel Level, typename Builder>
+    inline
+    void
+    LayoutItem::lazyLog(Builder builder) const {
+      static_assert(Level != LogLevel::Error, "Errors should be reported with the `error` method");
+
+      if constexpr (isLogLevelCompiled(Level)) {
+        if (!isLogLevelEnabled(Level)) {
+          return;
+        }
+
+        const std::string message = builder();
+
+        if constexpr (Level == LogLevel::Verbose) {
+          verbose(message);
+        }
+        else if constexpr (Level == LogLevel::Debug) {
+          debug(message);
+        }
+        else if constexpr (Level == LogLevel::Info) {
+          info(message);
+        }
+        else if constexpr (Level == LogLevel::Notice) {
+          notice(message);
+        }
+        else {
+          warn(message);
+        }
+      }
+    }
+
+    inline
+    bool
+    LayoutItem::isOpaque() const noexcept {
+      // Assume items can be transparent.
+      return false;
+    }
+
     inline
     bool
     LayoutItem::hasFocus() const noexcept {
@@ -122,14 +172,25 @@ namespace sdl {
       return std::to_string(getZOrder());
     }
 
+    inline
+    ZOrderKey
+    LayoutItem::getZOrderKey() const noexcept {
+      return ZOrderKey(getZOrder());
+    }
+
     inline
     void
     LayoutItem::setZOrder(int order) {
       // Assign the new z order value.
       m_zOrder = order;
 
+      // The stacking order of this item changed: caches relying on it should
+      // be refreshed.
+      invalidateGeometryEpoch();
+      hitAreaChanged();
+
       // Create a new event of the corresponding type.
-      postEvent(std::make_shared<engine::Event>(engine::Event::Type::ZOrderChanged));
+      postEvent(EventsPool::create<engine::Event>(engine::Event::Type::ZOrderChanged));
     }
 
     inline
@@ -165,10 +226,10 @@ namespace sdl {
 
       // Issue an event based on the current status.
       if (visible) {
-        e = std::make_shared<engine::Event>(engine::Event::Type::Show);
+        e = EventsPool::create<engine::Event>(engine::Event::Type::Show);
       }
       else {
-        e = std::make_shared<engine::HideEvent>(getDrawingArea());
+        e = EventsPool::create<engine::HideEvent>(getDrawingArea());
       }
 
       // Post this event.
@@ -186,23 +247,41 @@ namespace sdl {
     LayoutItem::filterEvent(engine::EngineObject* watched,
                             engine::EventShPtr e)
     {
-      // Handle mouse events: if the mouse event should be filtered we don't apply
-      // other filters. Otherwise it continues to cascade through the filters.
-      engine::MouseEventShPtr me = std::dynamic_pointer_cast<engine::MouseEvent>(e);
-      if (me != nullptr && filterMouseEvents(watched, me)) {
-        return true;
-      }
-
-      // Handle keyboard events: same principle as for mouse events.
-      engine::KeyEventShPtr ke = std::dynamic_pointer_cast<engine::KeyEvent>(e);
-      if (ke != nullptr && filterKeyboardEvents(watched, ke)) {
-        return true;
-      }
-
-      // Apply filtering on drag and drop events.
-      engine::DropEventShPtr de = std::dynamic_pointer_cast<engine::DropEvent>(e);
-      if (de != nullptr && filterDragAndDropEvents(watched, de)) {
-        return true;
+      // Dispatch the event to the dedicated filter based on its type: the type
+      // of an event determines its class so we don't need to query the type
+      // information of the event. Events which are not related to the input
+      // devices directly reach the base class method.
+      // The filters are reached through their shared pointer overload so that
+      // inheriting classes specializing it keep working.
+      switch (e->getType()) {
+        case engine::Event::Type::MouseButtonPress:
+        case engine::Event::Type::MouseButtonRelease:
+        case engine::Event::Type::MouseDoubleClick:
+        case engine::Event::Type::MouseDrag:
+        case engine::Event::Type::MouseMove:
+        case engine::Event::Type::MouseWheel:
+          // Handle mouse events: if the mouse event should be filtered we don't
+          // apply other filters. Otherwise it continues to cascade through the
+          // filters.
+          if (filterMouseEvents(watched, std::static_pointer_cast<engine::MouseEvent>(e))) {
+            return true;
+          }
+          break;
+        case engine::Event::Type::KeyPress:
+        case engine::Event::Type::KeyRelease:
+          // Handle keyboard events: same principle as for mouse events.
+          if (filterKeyboardEvents(watched, std::static_pointer_cast<engine::KeyEvent>(e))) {
+            return true;
+          }
+          break;
+        case engine::Event::Type::Drop:
+          // Apply filtering on drag and drop events.
+          if (filterDragAndDropEvents(watched, std::static_pointer_cast<engine::DropEvent>(e))) {
+            return true;
+          }
+          break;
+        default:
+          break;
       }
 
       // All the attempts at filtering the input event failed: use the base class
@@ -266,8 +345,31 @@ namespace sdl {
       // Mark the geometry as dirty.
       m_geometryDirty = true;
 
-      // Trigger a geometry update event.
-      postEvent(std::make_shared<engine::Event>(engine::Event::Type::GeometryUpdate));
+      // A synchronous pass recomputes the geometry right away.
+      if (m_geometryPass == GeometryPass::Synchronous) {
+        return;
+      }
+
+      // Trigger a geometry update event if none is pending already: the
+      // recomputation will account for all the changes anyway.
+      if (m_geometryUpdatePending.exchange(true)) {
+        ++m_suppressedGeometryUpdates;
+        return;
+      }
+
+      postEvent(EventsPool::create<engine::Event>(engine::Event::Type::GeometryUpdate));
+    }
+
+    inline
+    bool
+    LayoutItem::isApplyingGeometry() const noexcept {
+      return m_geometryPass != GeometryPass::Queued;
+    }
+
+    inline
+    unsigned
+    LayoutItem::getSuppressedGeometryUpdatesCount() const noexcept {
+      return m_suppressedGeometryUpdates;
     }
 
     inline
@@ -291,12 +393,36 @@ namespace sdl {
     inline
     bool
     LayoutItem::filterKeyboardEvents(const engine::EngineObject* /*watched*/,
-                                     const engine::KeyEventShPtr /*e*/) const noexcept
+                                     const engine::KeyEvent& /*e*/) const noexcept
     {
       // Empty implementation.
       return false;
     }
 
+    inline
+    bool
+    LayoutItem::filterMouseEvents(const engine::EngineObject* watched,
+                                  const engine::MouseEventShPtr e) const noexcept
+    {
+      return filterMouseEvents(watched, *e);
+    }
+
+    inline
+    bool
+    LayoutItem::filterKeyboardEvents(const engine::EngineObject* watched,
+                                     const engine::KeyEventShPtr e) const noexcept
+    {
+      return filterKeyboardEvents(watched, *e);
+    }
+
+    inline
+    bool
+    LayoutItem::filterDragAndDropEvents(const engine::EngineObject* watched,
+                                        const engine::DropEventShPtr e) const noexcept
+    {
+      return filterDragAndDropEvents(watched, *e);
+    }
+
     inline
     bool
     LayoutItem::hideEvent(const engine::HideEvent& e) {
@@ -306,18 +432,7 @@ namespace sdl {
       }
 
       // Assign the corresponding visible status.
-      bool changed = false;
-      {
-        const std::lock_guard guard(m_visibleLocker);
-        changed = (m_visible != false);
-        m_visible = false;
-      }
-
-      // Deactivate the events for this item only if we actually changed the
-      // internal status of the item.
-      if (changed) {
-        disableEventsProcessing();
-      }
+      assignVisibility(false);
 
       // Use the base handler to determine the return value.
       return engine::EngineObject::hideEvent(e);
@@ -356,18 +471,7 @@ namespace sdl {
       }
 
       // Assign the corresponding visible status.
-      bool changed = false;
-      {
-        const std::lock_guard guard(m_visibleLocker);
-        changed = (m_visible != true);
-        m_visible = true;
-      }
-
-      // Activate the events for this item only if we actually changed the
-      // internal status of the item.
-      if (changed) {
-        activateEventsProcessing();
-      }
+      assignVisibility(true);
 
       // Use the base handler to determine the return value.
       return engine::EngineObject::showEvent(e);
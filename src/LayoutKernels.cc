@@ -0,0 +1,221 @@
+
+# include "LayoutKernels.hh"
+# include <cmath>
+
+# if defined(__SSE2__)
+#  include <emmintrin.h>
+# endif
+
+namespace {
+
+# if defined(__SSE2__)
+
+  inline
+  __m128
+  select(__m128 mask,
+         __m128 a,
+         __m128 b) noexcept
+  {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+  }
+
+  inline
+  __m128
+  hasConstraint(__m128i flags,
+                std::uint32_t bit) noexcept
+  {
+    const __m128i b = _mm_set1_epi32(static_cast<int>(bit));
+    return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, b), b));
+  }
+
+# endif
+
+}
+
+namespace sdl {
+  namespace core {
+    namespace layout {
+
+      std::uint32_t
+      toConstraints(bool hintValid,
+                    bool fixed,
+                    bool shrink,
+                    bool extend) noexcept
+      {
+        return
+          (hintValid ? Constraint::HintValid : 0u) |
+          (fixed ? Constraint::Fixed : 0u) |
+          (shrink ? Constraint::Shrink : 0u) |
+          (extend ? Constraint::Extend : 0u)
+        ;
+      }
+
+      std::uint32_t
+      resolveAction(float desired,
+                    float achieved,
+                    float tolerance) noexcept
+      {
+        // Consider that the `achieved` size is close enough from the `desired`
+        // one to keep it.
+        if (std::abs(desired - achieved) < tolerance) {
+          return 0u;
+        }
+
+        if (desired < achieved) {
+          return Constraint::Shrink;
+        }
+        if (desired > achieved) {
+          return Constraint::Extend;
+        }
+
+        return 0u;
+      }
+
+      float
+      clamp(float current,
+            float delta,
+            float min,
+            float hint,
+            float max,
+            std::uint32_t flags) noexcept
+      {
+        const bool hintValid = (flags & Constraint::HintValid) != 0u;
+
+        // A fixed item uses its hint whatever the `delta` unless the hint is not
+        // valid, in which case the `delta` is used like for any other item.
+        if (hintValid && (flags & Constraint::Fixed) != 0u) {
+          return hint;
+        }
+
+        float output = current + delta;
+        if (output < min) {
+          output = min;
+        }
+        if (output > max) {
+          output = max;
+        }
+
+        if (!hintValid) {
+          return output;
+        }
+
+        // Items which can't shrink (resp. extend) keep their hint even though
+        // the `output` lies within the `[min; max]` range.
+        if (output < hint && (flags & Constraint::Shrink) == 0u) {
+          output = hint;
+        }
+        if (output > hint && (flags & Constraint::Extend) == 0u) {
+          output = hint;
+        }
+
+        return output;
+      }
+
+      bool
+      isUsable(float current,
+               float min,
+               float hint,
+               float max,
+               std::uint32_t flags,
+               std::uint32_t action) noexcept
+      {
+        const bool hintValid = (flags & Constraint::HintValid) != 0u;
+
+        const float low = (hintValid && (flags & Constraint::Shrink) == 0u ? hint : min);
+        const float high = (hintValid && (flags & Constraint::Extend) == 0u ? hint : max);
+
+        return
+          ((action & Constraint::Shrink) != 0u && current > low) ||
+          ((action & Constraint::Extend) != 0u && current < high)
+        ;
+      }
+
+      void
+      clampAxis(const AxisInfo& axis,
+                const float* delta,
+                float* out) noexcept
+      {
+        const unsigned count = axis.current.size();
+        unsigned id = 0u;
+
+# if defined(__SSE2__)
+        for ( ; id + 4u <= count ; id += 4u) {
+          const __m128 mn = _mm_loadu_ps(axis.min.data() + id);
+          const __m128 hn = _mm_loadu_ps(axis.hint.data() + id);
+          const __m128 mx = _mm_loadu_ps(axis.max.data() + id);
+          const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(axis.flags.data() + id));
+
+          const __m128 hintValid = hasConstraint(f, Constraint::HintValid);
+          const __m128 fixed = hasConstraint(f, Constraint::Fixed);
+          const __m128 shrink = hasConstraint(f, Constraint::Shrink);
+          const __m128 extend = hasConstraint(f, Constraint::Extend);
+
+          // Same steps as `clamp`: the fixed items are handled last so that
+          // the hint overrides any other result.
+          __m128 o = _mm_add_ps(_mm_loadu_ps(axis.current.data() + id), _mm_loadu_ps(delta + id));
+          o = select(_mm_cmplt_ps(o, mn), mn, o);
+          o = select(_mm_cmpgt_ps(o, mx), mx, o);
+          o = select(_mm_and_ps(hintValid, _mm_andnot_ps(shrink, _mm_cmplt_ps(o, hn))), hn, o);
+          o = select(_mm_and_ps(hintValid, _mm_andnot_ps(extend, _mm_cmpgt_ps(o, hn))), hn, o);
+          o = select(_mm_and_ps(hintValid, fixed), hn, o);
+
+          _mm_storeu_ps(out + id, o);
+        }
+# endif
+
+        for ( ; id < count ; ++id) {
+          out[id] = clamp(axis.current[id], delta[id], axis.min[id], axis.hint[id], axis.max[id], axis.flags[id]);
+        }
+      }
+
+      void
+      usableAxis(const AxisInfo& axis,
+                 std::uint32_t action,
+                 std::uint8_t* out) noexcept
+      {
+        const unsigned count = axis.current.size();
+        unsigned id = 0u;
+
+# if defined(__SSE2__)
+        const __m128 shrinkAll = _mm_castsi128_ps(_mm_set1_epi32((action & Constraint::Shrink) != 0u ? -1 : 0));
+        const __m128 extendAll = _mm_castsi128_ps(_mm_set1_epi32((action & Constraint::Extend) != 0u ? -1 : 0));
+
+        for ( ; id + 4u <= count ; id += 4u) {
+          const __m128 cur = _mm_loadu_ps(axis.current.data() + id);
+          const __m128 hn = _mm_loadu_ps(axis.hint.data() + id);
+          const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(axis.flags.data() + id));
+
+          const __m128 hintValid = hasConstraint(f, Constraint::HintValid);
+          const __m128 low = select(_mm_andnot_ps(hasConstraint(f, Constraint::Shrink), hintValid), hn, _mm_loadu_ps(axis.min.data() + id));
+          const __m128 high = select(_mm_andnot_ps(hasConstraint(f, Constraint::Extend), hintValid), hn, _mm_loadu_ps(axis.max.data() + id));
+
+          const int mask = _mm_movemask_ps(
+            _mm_or_ps(
+              _mm_and_ps(shrinkAll, _mm_cmpgt_ps(cur, low)),
+              _mm_and_ps(extendAll, _mm_cmplt_ps(cur, high))
+            )
+          );
+
+          for (unsigned lane = 0u ; lane < 4u ; ++lane) {
+            out[id + lane] = static_cast<std::uint8_t>((mask >> lane) & 1);
+          }
+        }
+# endif
+
+        for ( ; id < count ; ++id) {
+          out[id] = (isUsable(axis.current[id], axis.min[id], axis.hint[id], axis.max[id], axis.flags[id], action) ? 1u : 0u);
+        }
+      }
+
+      const char*
+      getKernelsName() noexcept {
+# if defined(__SSE2__)
+        return "sse2";
+# else
+        return "scalar";
+# endif
+      }
+
+    }
+  }
+}
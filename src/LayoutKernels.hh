@@ -0,0 +1,142 @@
+#ifndef    LAYOUT_KERNELS_HH
+# define   LAYOUT_KERNELS_HH
+
+# include <vector>
+# include <cstdint>
+
+namespace sdl {
+  namespace core {
+    namespace layout {
+
+      /**
+       * @brief - Bits describing the constraints applied on an item along a single
+       *          axis. The `Shrink` and `Extend` bits are also used to describe the
+       *          action to perform on the items of a layout along an axis.
+       */
+      enum Constraint: std::uint32_t {
+        HintValid = 1u << 0u,
+        Fixed     = 1u << 1u,
+        Shrink    = 1u << 2u,
+        Extend    = 1u << 3u
+      };
+
+      /**
+       * @brief - Describes the constraints of a list of items along a single axis: each
+       *          array contains one value per item. The `flags` are a combination of the
+       *          `Constraint` bits.
+       */
+      struct AxisInfo {
+        std::vector<float> current;
+        std::vector<float> min;
+        std::vector<float> hint;
+        std::vector<float> max;
+        std::vector<std::uint32_t> flags;
+      };
+
+      /**
+       * @brief - Builds the constraints bits of an item along an axis.
+       * @param hintValid - whether the item provides a valid size hint.
+       * @param fixed - whether the size of the item is fixed along the axis.
+       * @param shrink - whether the item can shrink along the axis.
+       * @param extend - whether the item can extend along the axis.
+       * @return - the combination of `Constraint` bits.
+       */
+      std::uint32_t
+      toConstraints(bool hintValid,
+                    bool fixed,
+                    bool shrink,
+                    bool extend) noexcept;
+
+      /**
+       * @brief - Determines the action to perform along an axis so that the `achieved`
+       *          size matches the `desired` one.
+       * @param desired - the desired size along the axis.
+       * @param achieved - the size achieved along the axis.
+       * @param tolerance - the difference below which both sizes are considered equal.
+       * @return - `Shrink` if the achieved size is too large, `Extend` if it is too
+       *           small and `0` otherwise.
+       */
+      std::uint32_t
+      resolveAction(float desired,
+                    float achieved,
+                    float tolerance) noexcept;
+
+      /**
+       * @brief - Clamps the size of a single item along an axis after applying the
+       *          `delta` to its `current` size. A fixed item with a valid hint always
+       *          uses its hint. Otherwise the size is clamped to `[min; max]` and then
+       *          replaced by the hint if the item is not allowed to shrink (or extend)
+       *          below (or beyond) it.
+       * @param current - the current size of the item.
+       * @param delta - the size delta to apply to the item.
+       * @param min - the minimum size of the item.
+       * @param hint - the size hint of the item.
+       * @param max - the maximum size of the item.
+       * @param flags - the `Constraint` bits of the item.
+       * @return - the size of the item.
+       */
+      float
+      clamp(float current,
+            float delta,
+            float min,
+            float hint,
+            float max,
+            std::uint32_t flags) noexcept;
+
+      /**
+       * @brief - Determines whether a single item can be used to perform the `action`
+       *          along an axis. When a hint is provided it replaces the minimum (resp.
+       *          maximum) size if the item is not allowed to shrink (resp. extend).
+       * @param current - the current size of the item.
+       * @param min - the minimum size of the item.
+       * @param hint - the size hint of the item.
+       * @param max - the maximum size of the item.
+       * @param flags - the `Constraint` bits of the item.
+       * @param action - a combination of the `Shrink` and `Extend` bits.
+       * @return - `true` if the item can be used to perform at least part of the action.
+       */
+      bool
+      isUsable(float current,
+               float min,
+               float hint,
+               float max,
+               std::uint32_t flags,
+               std::uint32_t action) noexcept;
+
+      /**
+       * @brief - Equivalent to calling `clamp` for each item of the `axis`. The items are
+       *          processed several at once when the processor supports it.
+       * @param axis - the description of the items along the axis.
+       * @param delta - the size delta to apply to each item.
+       * @param out - the output size of each item. Can be the same as `delta`.
+       */
+      void
+      clampAxis(const AxisInfo& axis,
+                const float* delta,
+                float* out) noexcept;
+
+      /**
+       * @brief - Equivalent to calling `isUsable` for each item of the `axis`. The items
+       *          are processed several at once when the processor supports it.
+       * @param axis - the description of the items along the axis.
+       * @param action - a combination of the `Shrink` and `Extend` bits.
+       * @param out - set to `1` for each usable item and to `0` otherwise.
+       */
+      void
+      usableAxis(const AxisInfo& axis,
+                 std::uint32_t action,
+                 std::uint8_t* out) noexcept;
+
+      /**
+       * @brief - Returns the name of the instruction set used by `clampAxis` and the
+       *          method `usableAxis`.
+       * @return - the name of the kernels.
+       */
+      const char*
+      getKernelsName() noexcept;
+
+    }
+  }
+}
+
+#endif    /* LAYOUT_KERNELS_HH */
@@ -0,0 +1,52 @@
+
+# include "LogLevel.hh"
+# include <atomic>
+
+namespace sdl {
+  namespace core {
+
+    namespace {
+
+      /**
+       * @brief - The default minimum level of the messages produced at runtime:
+       *          verbose and debug messages are not built unless requested, and
+       *          the compile time floor is used if it is more restrictive.
+       */
+      constexpr
+      LogLevel
+      defaultLogLevel() noexcept {
+        return
+          SDL_CORE_MIN_LOG_LEVEL > static_cast<int>(LogLevel::Info) ?
+          static_cast<LogLevel>(SDL_CORE_MIN_LOG_LEVEL) :
+          LogLevel::Info
+        ;
+      }
+
+      /**
+       * @brief - The minimum level of the messages produced at runtime, shared by
+       *          all the elements of the library.
+       */
+      std::atomic<LogLevel> logLevel(defaultLogLevel());
+
+    }
+
+    LogLevel
+    getLogLevel() noexcept {
+      return logLevel.load();
+    }
+
+    void
+    setLogLevel(LogLevel level) noexcept {
+      logLevel = level;
+    }
+
+    bool
+    isLogLevelEnabled(LogLevel level) noexcept {
+      return
+        isLogLevelCompiled(level) &&
+        static_cast<int>(level) >= static_cast<int>(getLogLevel())
+      ;
+    }
+
+  }
+}
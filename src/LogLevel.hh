@@ -0,0 +1,73 @@
+#ifndef    LOG_LEVEL_HH
+# define   LOG_LEVEL_HH
+
+/**
+ * @brief - The minimum level of the log messages which are compiled in the
+ *          library: lazy log calls with a lower level are removed entirely
+ *          at compile time. The value corresponds to the `LogLevel` enum,
+ *          the default keeps all the messages.
+ */
+# ifndef SDL_CORE_MIN_LOG_LEVEL
+#  define SDL_CORE_MIN_LOG_LEVEL 0
+# endif
+
+namespace sdl {
+  namespace core {
+
+    /**
+     * @brief - The levels of the log messages, by ascending order of severity.
+     */
+    enum class LogLevel {
+      Verbose = 0,
+      Debug = 1,
+      Info = 2,
+      Notice = 3,
+      Warning = 4,
+      Error = 5
+    };
+
+    /**
+     * @brief - Used to determine whether the messages with the specified level are
+     *          compiled in the library.
+     * @param level - the level to check.
+     * @return - `true` if messages with this level can be produced.
+     */
+    constexpr
+    bool
+    isLogLevelCompiled(LogLevel level) noexcept {
+      return static_cast<int>(level) >= SDL_CORE_MIN_LOG_LEVEL;
+    }
+
+    /**
+     * @brief - Retrieves the minimum level of the messages which are produced at
+     *          runtime. Default is `LogLevel::Info` (or the compile time floor if
+     *          it is higher): verbose and debug messages compiled in the library
+     *          are only built once a lower level is requested with `setLogLevel`.
+     * @return - the current minimum log level.
+     */
+    LogLevel
+    getLogLevel() noexcept;
+
+    /**
+     * @brief - Assigns the minimum level of the messages which are produced at
+     *          runtime. Messages with a lower level are discarded before being
+     *          built. This setting is shared by all the elements of the library.
+     * @param level - the new minimum log level.
+     */
+    void
+    setLogLevel(LogLevel level) noexcept;
+
+    /**
+     * @brief - Used to determine whether messages with the specified level should
+     *          be produced: it accounts for both the compile time and the runtime
+     *          levels.
+     * @param level - the level to check.
+     * @return - `true` if messages with this level should be produced.
+     */
+    bool
+    isLogLevelEnabled(LogLevel level) noexcept;
+
+  }
+}
+
+#endif    /* LOG_LEVEL_HH */
@@ -0,0 +1,140 @@
+
+# include "NamesTable.hh"
+# include <mutex>
+# include <deque>
+# include <vector>
+# include <shared_mutex>
+# include <string_view>
+# include <unordered_map>
+
+namespace sdl {
+  namespace core {
+
+    namespace {
+
+      /**
+       * @brief - A name registered in the table along with the number of references
+       *          to it. A count of `0` indicates that the entry is free.
+       */
+      struct Entry {
+        std::string name;
+        unsigned count;
+      };
+
+      /**
+       * @brief - The names registered so far: the identifier of a name is its index
+       *          in the `entries` plus one. A deque is used so that the indexed views
+       *          stay valid when new names are added. Released entries are kept in
+       *          the `available` list to be reused by later names.
+       *          Lookups only need a shared access to the table.
+       */
+      struct Table {
+        std::shared_mutex locker;
+        std::deque<Entry> entries;
+        std::vector<NamesTable::Handle> available;
+        std::unordered_map<std::string_view, NamesTable::Handle> handles;
+      };
+
+      /**
+       * @brief - The table is never destroyed: names might still be queried by
+       *          static objects at exit.
+       */
+      Table&
+      getTable() noexcept {
+        static Table* table = new Table();
+        return *table;
+      }
+
+    }
+
+    NamesTable::Handle
+    NamesTable::intern(const std::string& name) {
+      Table& table = getTable();
+      const std::lock_guard guard(table.locker);
+
+      std::unordered_map<std::string_view, Handle>::const_iterator it = table.handles.find(name);
+      if (it != table.handles.cend()) {
+        ++table.entries[it->second - 1u].count;
+        return it->second;
+      }
+
+      // Reuse a released entry if possible.
+      Handle handle = 0u;
+      if (!table.available.empty()) {
+        handle = table.available.back();
+        table.entries[handle - 1u] = Entry{name, 1u};
+        table.available.pop_back();
+      }
+      else {
+        // Make sure that all the entries can be released without allocating.
+        if (table.available.capacity() <= table.entries.size()) {
+          table.available.reserve(2u * table.entries.size() + 1u);
+        }
+
+        table.entries.push_back(Entry{name, 1u});
+        handle = table.entries.size();
+      }
+
+      table.handles.emplace(table.entries[handle - 1u].name, handle);
+
+      return handle;
+    }
+
+    void
+    NamesTable::release(Handle handle) noexcept {
+      Table& table = getTable();
+      const std::lock_guard guard(table.locker);
+
+      if (handle == 0u || handle > table.entries.size() || table.entries[handle - 1u].count == 0u) {
+        return;
+      }
+
+      Entry& entry = table.entries[handle - 1u];
+      --entry.count;
+
+      if (entry.count > 0u) {
+        return;
+      }
+
+      // Erase the name: the view in the `handles` refers to the string of the
+      // entry so it should be removed first.
+      table.handles.erase(entry.name);
+      std::string().swap(entry.name);
+
+      // The capacity was reserved when the entry was created.
+      table.available.push_back(handle);
+    }
+
+    NamesTable::Handle
+    NamesTable::find(const std::string& name) noexcept {
+      Table& table = getTable();
+      const std::shared_lock guard(table.locker);
+
+      std::unordered_map<std::string_view, Handle>::const_iterator it = table.handles.find(name);
+      return (it == table.handles.cend() ? 0u : it->second);
+    }
+
+    const std::string&
+    NamesTable::getName(Handle handle) noexcept {
+      static const std::string empty;
+
+      Table& table = getTable();
+      const std::shared_lock guard(table.locker);
+
+      if (handle == 0u || handle > table.entries.size()) {
+        return empty;
+      }
+
+      return table.entries[handle - 1u].name;
+    }
+
+    unsigned
+    NamesTable::getSize() noexcept {
+      Table& table = getTable();
+      const std::shared_lock guard(table.locker);
+
+      return table.handles.size();
+    }
+
+  }
+}
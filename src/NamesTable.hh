@@ -0,0 +1,74 @@
+#ifndef    NAMES_TABLE_HH
+# define   NAMES_TABLE_HH
+
+# include <string>
+
+namespace sdl {
+  namespace core {
+
+    class NamesTable {
+      public:
+
+        /**
+         * @brief - Convenience define to refer to the identifier of a name in the
+         *          table. A value of `0` never refers to a valid name.
+         */
+        using Handle = unsigned;
+
+        /**
+         * @brief - Registers the input name in the table if needed and returns its
+         *          identifier. Each distinct name is stored only once and keeps the
+         *          same identifier as long as it is referenced: this allows to compare
+         *          and hash names as plain integers.
+         *          Each call adds a reference to the name which should be removed by
+         *          a call to `release` once the identifier is not used anymore.
+         * @param name - the name to register.
+         * @return - the identifier of the name.
+         */
+        static
+        Handle
+        intern(const std::string& name);
+
+        /**
+         * @brief - Removes a reference to the name associated to the input identifier.
+         *          When the last reference is removed the name is erased from the table
+         *          and its identifier can be reused for another name.
+         * @param handle - the identifier of the name to release.
+         */
+        static
+        void
+        release(Handle handle) noexcept;
+
+        /**
+         * @brief - Retrieves the identifier of the input name without registering it.
+         * @param name - the name to search for.
+         * @return - the identifier of the name or `0` if it was never registered.
+         */
+        static
+        Handle
+        find(const std::string& name) noexcept;
+
+        /**
+         * @brief - Retrieves the name associated to the input identifier. Returns an
+         *          empty string if the identifier is not valid. The returned reference
+         *          is only valid as long as the name is referenced.
+         * @param handle - the identifier of the name.
+         * @return - the corresponding name.
+         */
+        static
+        const std::string&
+        getName(Handle handle) noexcept;
+
+        /**
+         * @brief - Returns the number of distinct names registered in the table.
+         * @return - the size of the table.
+         */
+        static
+        unsigned
+        getSize() noexcept;
+    };
+
+  }
+}
+
+#endif    /* NAMES_TABLE_HH */
@@ -0,0 +1,226 @@
+
+# include "Region.hh"
+# include <algorithm>
+
+namespace sdl {
+  namespace core {
+
+    Region::Region():
+      m_rectangles()
+    {}
+
+    Region::Region(const utils::Boxf& box):
+      m_rectangles()
+    {
+      add(box);
+    }
+
+    void
+    Region::add(const utils::Boxf& box) {
+      // Discard degenerated boxes.
+      const Edges added = toEdges(box);
+      if (!isValid(added)) {
+        return;
+      }
+
+      // In order to keep the rectangles of the region non-overlapping
+      // we need to remove from the input box any part already covered
+      // by the region. Each existing rectangle potentially splits the
+      // pieces remaining from the input box.
+      std::vector<Edges> pieces(1u, added);
+      std::vector<Edges> remaining;
+
+      for (Rectangles::const_iterator rect = m_rectangles.cbegin() ; rect != m_rectangles.cend() && !pieces.empty() ; ++rect) {
+        const Edges cut = toEdges(*rect);
+
+        remaining.clear();
+        for (std::vector<Edges>::const_iterator piece = pieces.cbegin() ; piece != pieces.cend() ; ++piece) {
+          split(*piece, cut, remaining);
+        }
+
+        pieces.swap(remaining);
+      }
+
+      // Whatever remains is not yet part of the region.
+      for (std::vector<Edges>::const_iterator piece = pieces.cbegin() ; piece != pieces.cend() ; ++piece) {
+        m_rectangles.push_back(fromEdges(*piece));
+      }
+    }
+
+    void
+    Region::subtract(const utils::Boxf& box) {
+      const Edges cut = toEdges(box);
+      if (!isValid(cut)) {
+        return;
+      }
+
+      std::vector<Edges> pieces;
+      for (Rectangles::const_iterator rect = m_rectangles.cbegin() ; rect != m_rectangles.cend() ; ++rect) {
+        split(toEdges(*rect), cut, pieces);
+      }
+
+      m_rectangles.clear();
+      for (std::vector<Edges>::const_iterator piece = pieces.cbegin() ; piece != pieces.cend() ; ++piece) {
+        m_rectangles.push_back(fromEdges(*piece));
+      }
+    }
+
+    void
+    Region::clip(const utils::Boxf& box) {
+      const Edges bounds = toEdges(box);
+
+      Rectangles clipped;
+      for (Rectangles::const_iterator rect = m_rectangles.cbegin() ; rect != m_rectangles.cend() ; ++rect) {
+        const Edges source = toEdges(*rect);
+        const Edges inter{
+          std::max(source.left, bounds.left),
+          std::min(source.right, bounds.right),
+          std::max(source.bottom, bounds.bottom),
+          std::min(source.top, bounds.top)
+        };
+
+        if (isValid(inter)) {
+          clipped.push_back(fromEdges(inter));
+        }
+      }
+
+      m_rectangles.swap(clipped);
+    }
+
+    void
+    Region::coalesce() {
+      // Work on the edges representation which makes it easy to detect
+      // rectangles sharing a complete edge. As the rectangles do not
+      // overlap, merging two of them never produces an overlap with a
+      // third one. We loop until no more merge can be performed.
+      std::vector<Edges> edges;
+      edges.reserve(m_rectangles.size());
+      for (Rectangles::const_iterator rect = m_rectangles.cbegin() ; rect != m_rectangles.cend() ; ++rect) {
+        edges.push_back(toEdges(*rect));
+      }
+
+      bool merged = true;
+      while (merged) {
+        merged = false;
+
+        for (unsigned i = 0u ; i < edges.size() && !merged ; ++i) {
+          for (unsigned j = i + 1u ; j < edges.size() && !merged ; ++j) {
+            const Edges& a = edges[i];
+            const Edges& b = edges[j];
+
+            // Vertical neighbours: same horizontal extent and touching
+            // along their bottom or top edge.
+            const bool vertical =
+              fuzzyEqual(a.left, b.left) &&
+              fuzzyEqual(a.right, b.right) &&
+              (fuzzyEqual(a.top, b.bottom) || fuzzyEqual(b.top, a.bottom))
+            ;
+
+            // Horizontal neighbours: same vertical extent and touching
+            // along their left or right edge.
+            const bool horizontal =
+              fuzzyEqual(a.bottom, b.bottom) &&
+              fuzzyEqual(a.top, b.top) &&
+              (fuzzyEqual(a.right, b.left) || fuzzyEqual(b.right, a.left))
+            ;
+
+            if (!vertical && !horizontal) {
+              continue;
+            }
+
+            edges[i] = Edges{
+              std::min(a.left, b.left),
+              std::max(a.right, b.right),
+              std::min(a.bottom, b.bottom),
+              std::max(a.top, b.top)
+            };
+            edges.erase(edges.begin() + j);
+
+            merged = true;
+          }
+        }
+      }
+
+      m_rectangles.clear();
+      for (std::vector<Edges>::const_iterator edge = edges.cbegin() ; edge != edges.cend() ; ++edge) {
+        m_rectangles.push_back(fromEdges(*edge));
+      }
+    }
+
+    bool
+    Region::intersects(const utils::Boxf& box) const noexcept {
+      const Edges other = toEdges(box);
+
+      for (Rectangles::const_iterator rect = m_rectangles.cbegin() ; rect != m_rectangles.cend() ; ++rect) {
+        const Edges source = toEdges(*rect);
+        const Edges inter{
+          std::max(source.left, other.left),
+          std::min(source.right, other.right),
+          std::max(source.bottom, other.bottom),
+          std::min(source.top, other.top)
+        };
+
+        if (isValid(inter)) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    bool
+    Region::contains(const utils::Boxf& box) const {
+      // The box is contained in the region if nothing remains of it
+      // once all the rectangles of the region have been removed.
+      Region rest(box);
+
+      for (Rectangles::const_iterator rect = m_rectangles.cbegin() ; rect != m_rectangles.cend() && !rest.empty() ; ++rect) {
+        rest.subtract(*rect);
+      }
+
+      return rest.empty();
+    }
+
+    void
+    Region::split(const Edges& source,
+                  const Edges& cut,
+                  std::vector<Edges>& out)
+    {
+      // In case both rectangles do not intersect, the source is kept
+      // entirely.
+      if (cut.left >= source.right || cut.right <= source.left ||
+          cut.bottom >= source.top || cut.top <= source.bottom)
+      {
+        out.push_back(source);
+        return;
+      }
+
+      // Otherwise we produce at most four pieces: the left and right
+      // bands span the whole height of the source while the bottom
+      // and top ones are restricted to the horizontal extent of the
+      // cut area.
+      const Edges left{source.left, cut.left, source.bottom, source.top};
+      const Edges right{cut.right, source.right, source.bottom, source.top};
+
+      const float l = std::max(source.left, cut.left);
+      const float r = std::min(source.right, cut.right);
+
+      const Edges bottom{l, r, source.bottom, cut.bottom};
+      const Edges top{l, r, cut.top, source.top};
+
+      if (isValid(left)) {
+        out.push_back(left);
+      }
+      if (isValid(right)) {
+        out.push_back(right);
+      }
+      if (isValid(bottom)) {
+        out.push_back(bottom);
+      }
+      if (isValid(top)) {
+        out.push_back(top);
+      }
+    }
+
+  }
+}
@@ -0,0 +1,199 @@
+#ifndef    REGION_HH
+# define   REGION_HH
+
+# include <vector>
+# include <maths_utils/Box.hh>
+
+namespace sdl {
+  namespace core {
+
+    class Region {
+      public:
+
+        /**
+         * @brief - Convenience define to refer to the list of rectangles composing
+         *          a region.
+         */
+        using Rectangles = std::vector<utils::Boxf>;
+
+        /**
+         * @brief - Creates an empty region.
+         */
+        Region();
+
+        /**
+         * @brief - Creates a region covering exactly the input box. If the box is
+         *          not valid the region is empty.
+         * @param box - the initial area covered by this region.
+         */
+        explicit
+        Region(const utils::Boxf& box);
+
+        ~Region() = default;
+
+        /**
+         * @brief - Used to determine whether this region covers any area.
+         * @return - `true` if this region does not contain any rectangle.
+         */
+        bool
+        empty() const noexcept;
+
+        /**
+         * @brief - Returns the number of non-overlapping rectangles which are
+         *          currently used to describe this region.
+         * @return - the number of rectangles of the region.
+         */
+        unsigned
+        size() const noexcept;
+
+        /**
+         * @brief - Retrieves the list of rectangles composing this region. The
+         *          rectangles are guaranteed not to overlap each other so that
+         *          each point of the region is covered by exactly one of them.
+         * @return - the list of rectangles composing this region.
+         */
+        const Rectangles&
+        getRectangles() const noexcept;
+
+        /**
+         * @brief - Removes any area covered by this region.
+         */
+        void
+        clear() noexcept;
+
+        /**
+         * @brief - Adds the input box to this region. Only the parts of the box
+         *          which are not already covered by the region are added so that
+         *          the rectangles composing the region never overlap. Invalid
+         *          boxes are ignored.
+         * @param box - the area to add to this region.
+         */
+        void
+        add(const utils::Boxf& box);
+
+        /**
+         * @brief - Removes the input box from this region. Rectangles partially
+         *          covered by the box are split into at most four pieces.
+         * @param box - the area to remove from this region.
+         */
+        void
+        subtract(const utils::Boxf& box);
+
+        /**
+         * @brief - Restricts this region to the area covered by the input box.
+         * @param box - the area to which this region should be clipped.
+         */
+        void
+        clip(const utils::Boxf& box);
+
+        /**
+         * @brief - Merges the rectangles of this region which share a complete
+         *          edge into a single rectangle. This does not change the area
+         *          covered by the region but reduces the number of rectangles
+         *          needed to describe it.
+         */
+        void
+        coalesce();
+
+        /**
+         * @brief - Used to determine whether the input box intersects with any
+         *          part of this region.
+         * @param box - the box to check for intersection.
+         * @return - `true` if at least one rectangle of the region intersects
+         *           the input box.
+         */
+        bool
+        intersects(const utils::Boxf& box) const noexcept;
+
+        /**
+         * @brief - Used to determine whether the input box is entirely covered
+         *          by this region. Note that the box can be spread across some
+         *          of the rectangles composing the region.
+         * @param box - the box to check for inclusion.
+         * @return - `true` if each point of the box is covered by the region.
+         */
+        bool
+        contains(const utils::Boxf& box) const;
+
+      private:
+
+        /**
+         * @brief - Convenience structure describing a rectangle through its
+         *          edges rather than through its center and dimensions. This
+         *          representation is more suited to perform the splitting and
+         *          merging operations.
+         */
+        struct Edges {
+          float left;
+          float right;
+          float bottom;
+          float top;
+        };
+
+        /**
+         * @brief - Converts the input box into its edges representation.
+         * @param box - the box to convert.
+         * @return - the edges of the box.
+         */
+        static
+        Edges
+        toEdges(const utils::Boxf& box) noexcept;
+
+        /**
+         * @brief - Converts the input edges into a box.
+         * @param edges - the edges to convert.
+         * @return - the box described by the edges.
+         */
+        static
+        utils::Boxf
+        fromEdges(const Edges& edges) noexcept;
+
+        /**
+         * @brief - Used to determine whether the input edges describe a rectangle
+         *          with a non-negligible area.
+         * @param edges - the edges to check.
+         * @return - `true` if the rectangle is not degenerated.
+         */
+        static
+        bool
+        isValid(const Edges& edges) noexcept;
+
+        /**
+         * @brief - Used to determine whether two coordinates are close enough to
+         *          be considered equal.
+         * @param lhs - the first coordinate.
+         * @param rhs - the second coordinate.
+         * @return - `true` if both coordinates are identical.
+         */
+        static
+        bool
+        fuzzyEqual(float lhs, float rhs) noexcept;
+
+        /**
+         * @brief - Splits the `source` rectangle into the pieces not covered by
+         *          `cut` and append them to the `out` list. At most four pieces
+         *          are produced.
+         * @param source - the rectangle to split.
+         * @param cut - the area to remove from the `source`.
+         * @param out - the output list where pieces should be appended.
+         */
+        static
+        void
+        split(const Edges& source,
+              const Edges& cut,
+              std::vector<Edges>& out);
+
+      private:
+
+        /**
+         * @brief - The list of non-overlapping rectangles composing this region.
+         */
+        Rectangles m_rectangles;
+    };
+
+  }
+}
+
+# include "Region.hxx"
+
+#endif    /* REGION_HH */
@@ -0,0 +1,74 @@
+#ifndef    REGION_HXX
+# define   REGION_HXX
+
+# include "Region.hh"
+# include <cmath>
+
+namespace sdl {
+  namespace core {
+
+    inline
+    bool
+    Region::empty() const noexcept {
+      return m_rectangles.empty();
+    }
+
+    inline
+    unsigned
+    Region::size() const noexcept {
+      return m_rectangles.size();
+    }
+
+    inline
+    const Region::Rectangles&
+    Region::getRectangles() const noexcept {
+      return m_rectangles;
+    }
+
+    inline
+    void
+    Region::clear() noexcept {
+      m_rectangles.clear();
+    }
+
+    inline
+    Region::Edges
+    Region::toEdges(const utils::Boxf& box) noexcept {
+      return Edges{
+        box.x() - box.w() / 2.0f,
+        box.x() + box.w() / 2.0f,
+        box.y() - box.h() / 2.0f,
+        box.y() + box.h() / 2.0f
+      };
+    }
+
+    inline
+    utils::Boxf
+    Region::fromEdges(const Edges& edges) noexcept {
+      return utils::Boxf(
+        (edges.left + edges.right) / 2.0f,
+        (edges.bottom + edges.top) / 2.0f,
+        edges.right - edges.left,
+        edges.top - edges.bottom
+      );
+    }
+
+    inline
+    bool
+    Region::fuzzyEqual(float lhs, float rhs) noexcept {
+      return std::abs(lhs - rhs) < 0.0001f;
+    }
+
+    inline
+    bool
+    Region::isValid(const Edges& edges) noexcept {
+      return
+        edges.right - edges.left > 0.0001f &&
+        edges.top - edges.bottom > 0.0001f
+      ;
+    }
+
+  }
+}
+
+#endif    /* REGION_HXX */
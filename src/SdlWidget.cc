@@ -1,6 +1,8 @@
 
 # include "SdlWidget.hh"
 # include <core_utils/SafetyNet.hh>
+# include <algorithm>
+# include <unordered_set>
 
 namespace sdl {
   namespace core {
@@ -11,26 +13,56 @@ namespace sdl {
                          const engine::Color& color):
       LayoutItem(name, sizeHint),
 
+      m_nameId(NamesTable::intern(name)),
       m_names(),
+      m_emitters(),
       m_children(),
-      m_childrenRepaints(),
+      m_childrenOrder(0u),
       m_tabOrder(),
       m_repaint(),
       m_childrenLocker(),
+      m_hitIndex(),
+      m_hitUpdates(),
+      m_hitRefresh(),
+      m_hitUpdatesLocker(),
+      m_zOrderKey(),
+      m_zOrderKeyEpoch(0u),
+      m_globalOffset(),
+      m_globalOffsetValid(false),
+      m_hierarchyLocker(),
 
       m_layout(),
       m_palette(engine::Palette::fromButtonColor(color)),
       m_engine(nullptr),
+      m_texturePool(nullptr),
 
       m_parent(nullptr),
+      m_childOrder(0u),
 
       m_contentDirty(true),
+      m_textureless(false),
+      m_fillRole(engine::Palette::ColorRole::Background),
+      m_opaque(false),
+      m_synchronousLayout(false),
+      m_updatesSuspended(0u),
+      m_deferredRepaint(false),
+      m_deferredGeometry(false),
+      m_pendingRepaint(false),
+      m_pendingGeometry(false),
+      m_subtreeDirty(true),
+      m_drawVisits(0u),
+      m_repaintRegions(0u),
+      m_repaintRectangles(0u),
+      m_occludedChildren(0u),
       m_mouseInside(false),
       m_internalFocusState(),
+      m_keyboardChild(nullptr),
+      m_focusRing(nullptr),
 
       m_content(),
       m_repaintOperation(nullptr),
       m_contentLocker(),
+      m_contentOwner(),
 
       m_cachedContent(),
       m_cacheLocker(),
@@ -45,7 +77,17 @@ namespace sdl {
       setParent(parent);
     }
 
+    std::atomic_uint SdlWidget::m_suspendedWidgets(0u);
+
     SdlWidget::~SdlWidget() {
+      // Widgets destroyed while suspending their updates should not be
+      // counted anymore.
+      if (m_updatesSuspended > 0u) {
+        --m_suspendedWidgets;
+      }
+
+      delete m_focusRing.exchange(nullptr);
+
       {
         const std::lock_guard guard(m_contentLocker);
         clearTexture();
@@ -58,6 +100,7 @@ namespace sdl {
         const std::lock_guard guard(m_childrenLocker);
 
         m_names.clear();
+        m_emitters.clear();
 
         for (WidgetsMap::const_iterator child = m_children.cbegin() ;
             child != m_children.cend() ;
@@ -69,34 +112,62 @@ namespace sdl {
         }
 
         m_tabOrder.clear();
-        m_childrenRepaints.clear();
       }
+
+      // Release the name of this widget: it can be erased from the table
+      // if no other widget uses it.
+      NamesTable::release(m_nameId);
     }
 
     utils::Uuid
     SdlWidget::draw() {
+      // This widget is visited by the current frame.
+      m_drawVisits = 1u;
+
+      // The root of the hierarchy performs the focus moves which could not
+      // be handled when the `Tab`s were received.
+      if (!hasParent()) {
+        updateFocusRing();
+      }
+
+      // Check whether this widget or any of its children has some pending
+      // graphic operations: if this is not the case the cached content is
+      // up-to-date and we can return it right away without traversing the
+      // children. The flag is reset before processing so that operations
+      // registered while we're drawing will be handled in the next frame.
+      // Textureless widgets do not have any content: they are drawn by
+      // their parent so we only need to reach their children.
+      const bool textureless = isTextureless();
+
+      if (!m_subtreeDirty.exchange(false)) {
+        return textureless ? utils::Uuid() : getContentUuid();
+      }
+
       // Perform the lock to process oending repaint events.
-      handleGraphicOperations();
+      if (!textureless) {
+        handleGraphicOperations();
+      }
 
       // We also need to traverse the list of children and
       // call the `draw` method on each one. This allows to
       // actually perform the pending graphic operations.
       // This will guarantee that repaint operations can
       // bubble up to the top level when needed.
+      // Only children marked as dirty are considered as the
+      // other ones do not have anything to update.
       {
-        utils::Sizef area = getRenderingArea().toSize();
-
         const std::lock_guard guard(m_childrenLocker);
 
         for (WidgetsMap::const_iterator child = m_children.cbegin() ; child != m_children.cend() ; ++child) {
-          if (child->widget->isVisible()) {
+          if (child->widget->m_subtreeDirty && child->widget->isVisible()) {
             child->widget->draw();
+            m_drawVisits += child->widget->m_drawVisits;
           }
         }
       }
 
       // Return the cached texture.
-      return getContentUuid();
+      return textureless ? utils::Uuid() : getContentUuid();
     }
 
     bool
@@ -115,11 +186,22 @@ namespace sdl {
         return false;
       }
 
+      // A textureless widget does not have any content to draw: only the
+      // children can handle the request so we need a valid `src` area.
+      const bool textureless = isTextureless();
+      if (textureless && src == nullptr) {
+        return false;
+      }
+
       // First, handle the case where `src` is null: in this case we just
       // want to draw the whole internal texture on the `on` texture at
-      // the specified `dst` position.
+      // the specified `dst` position. As the texture might be larger than
+      // this widget we restrict it to the part actually used.
+      const utils::Boxf spanned = getRenderingArea().toOrigin();
+
       if (src == nullptr) {
-        getEngine().drawTexture(m_cachedContent, src, &on, dst);
+        const utils::Boxf used = convertToEngineFormat(spanned, spanned);
+        getEngine().drawTexture(m_cachedContent, &used, &on, dst);
 
         // We're done.
         return true;
@@ -128,14 +210,13 @@ namespace sdl {
       // Now we now that `src` contains a value, we need to check whether
       // it is covered by this widget. If this is the case we can just
       // draw it at the desired position on the `on` texture and we're done.
-      const utils::Boxf spanned = getRenderingArea().toOrigin();
       const utils::Boxf inter = spanned.intersect(*src);
 
-      if (inter.valid()) {
+      if (!textureless && inter.valid()) {
         // Draw the internal content at the specified position and call
         // it done. We need to only draw the area which intersects the
         // actual `src` area.
-        debug("Widget contains area " + src->toString() + " (total: " + spanned.toString() + ", intersect: " + inter.toString() + ")");
+        lazyLog<LogLevel::Debug>([&]() { return "Widget contains area " + src->toString() + " (total: " + spanned.toString() + ", intersect: " + inter.toString() + ")"; });
 
         const utils::Boxf srcEngine = convertToEngineFormat(inter, spanned);
 
@@ -158,11 +239,13 @@ namespace sdl {
           // Convert the `src` area in terms of child coordinate frame and
           // perform the draw on operation.
           const utils::Boxf childSrc = convertToLocal(*src, child->widget->getRenderingArea());
-          verbose(
-            "Requesting child " + child->widget->getName() +
-            " with area " + childSrc.toString() +
-            " (from " + src->toString() + ", child: " + child->widget->getRenderingArea().toString() + ")"
-          );
+          lazyLog<LogLevel::Verbose>([&]() {
+            return
+              "Requesting child " + child->widget->getName() +
+              " with area " + childSrc.toString() +
+              " (from " + src->toString() + ", child: " + child->widget->getRenderingArea().toString() + ")"
+            ;
+          });
           const bool valid = child->widget->drawOn(on, &childSrc, dst);
 
           // Update the status boolean.
@@ -193,45 +276,36 @@ namespace sdl {
         return nullptr;
       }
 
-      // Collect valid children which spans the position.
-      std::vector<std::pair<std::string, const SdlWidget*>> elements;
+      // Map to local coordinate frame: this is the frame in which both the
+      // children are indexed and the `getRenderingArea` is expressed once
+      // moved to the origin.
+      const utils::Vector2f local = mapFromGlobal(pos);
+
+      // Use the spatial index to traverse the children which might span the
+      // position by descending z order: the first one returning a valid item
+      // is the best candidate. The entries of the children which changed are
+      // refreshed beforehand.
       {
         const std::lock_guard guard(m_childrenLocker);
 
-        for (WidgetsMap::const_iterator child = m_children.cbegin() ; child != m_children.cend() ; ++child) {
-          const SdlWidget* wig = child->widget->getItemAt(pos);
+        refreshHitIndex();
 
-          if (wig != nullptr) {
-            // Do not use the `z` order alone but rather the `z` order string which allows to
-            // take the order up until this parent in order to easily detect which widget needs
-            // to be stacked on top.
-            elements.push_back(std::make_pair(wig->getZOrderString(this), wig));
+        const SdlWidget* best = nullptr;
+        m_hitIndex.visit(local,
+          [&best, &pos](const SdlWidget* child) {
+            best = child->getItemAt(pos);
+            return best != nullptr;
           }
-        }
-      }
+        );
 
-      // Select the best candidate so far by using the z order.
-      std::sort(
-        elements.begin(),
-        elements.end(),
-        [](const std::pair<std::string, const SdlWidget*>& lhs, const std::pair<std::string, const SdlWidget*>& rhs) {
-          return lhs.first < rhs.first;
+        if (best != nullptr) {
+          return best;
         }
-      );
-
-      // Check whether at least one element can be found.
-      if (!elements.empty()) {
-        return elements.back().second;
       }
 
       // No element among the children was found to span the input position. We can safely deduce
       // that the best candidate we have is `this` object. We can return it in case the input
       // position spans the `pos`.
-
-      // Map to local coordinate frame. We will also have to map the `getRenderingArea` method to
-      // local coordinate frame as it returns a box in the parent's coordinate frame which is thus
-      // incompatible with the converted local position.
-      const utils::Vector2f local = mapFromGlobal(pos);
       const utils::Boxf thisSize = LayoutItem::getRenderingArea().toOrigin();
 
       if (thisSize.contains(local)) {
@@ -242,37 +316,78 @@ namespace sdl {
       return nullptr;
     }
 
+    utils::Boxf
+    SdlWidget::getHitArea() const noexcept {
+      // Start from the area of this widget in the parent's frame. We can't
+      // use the `getDrawingArea` method as it would lock the content of this
+      // widget which might already be locked in case the hit test is performed
+      // while processing one of its events.
+      const utils::Boxf area = LayoutItem::getRenderingArea();
+
+      // Extend it with the bounds of the children: these are expressed in
+      // the local frame of this widget and thus need to be moved in the one
+      // of the parent.
+      utils::Boxf children;
+      {
+        const std::lock_guard guard(m_childrenLocker);
+
+        refreshHitIndex();
+        children = m_hitIndex.getBounds();
+      }
+
+      if (!children.valid()) {
+        return area;
+      }
+
+      children.x() += area.x();
+      children.y() += area.y();
+
+      if (!area.valid()) {
+        return children;
+      }
+
+      const float left = std::min(area.x() - area.w() / 2.0f, children.x() - children.w() / 2.0f);
+      const float right = std::max(area.x() + area.w() / 2.0f, children.x() + children.w() / 2.0f);
+      const float bottom = std::min(area.y() - area.h() / 2.0f, children.y() - children.h() / 2.0f);
+      const float top = std::max(area.y() + area.h() / 2.0f, children.y() + children.h() / 2.0f);
+
+      return utils::Boxf((left + right) / 2.0f, (bottom + top) / 2.0f, right - left, top - bottom);
+    }
+
     bool
     SdlWidget::filterKeyboardEvents(const engine::EngineObject* watched,
-                                    const engine::KeyEventShPtr /*e*/) const noexcept
+                                    const engine::KeyEvent& /*e*/) const noexcept
     {
       // We need to check whether the item corresponding to the input `watched` item
       // has the keyboard focus. If this is the case we can transmit the key event to
       // it otherwise we need to filter it.
-      // If the watched object cannot be found in the internal array, we consider that
-      // the event is not filtered.
-      const std::lock_guard guard(m_childrenLocker);
+      // If the watched object is not one of our children, we consider that the event
+      // is not filtered.
 
-      // Traverse the internal list of items and stop as soon as we find the input
-      // `watched` object.
-      WidgetsMap::const_iterator child = m_children.cbegin();
-      while (child != m_children.cend()) {
-        if (child->widget == watched) {
-          return !child->widget->hasKeyboardFocus();
-        }
+      // Most of the time the event is sent to the child leading to the keyboard focus.
+      const SdlWidget* focused = m_keyboardChild;
+      if (focused != nullptr && focused == watched) {
+        return !focused->hasKeyboardFocus();
+      }
+
+      const std::lock_guard guard(m_childrenLocker);
 
-        ++child;
+      EmittersMap::const_iterator child = m_emitters.find(watched);
+      if (child == m_emitters.cend()) {
+        // No child matches the input `watched` object: consider the event as not filtered.
+        return false;
       }
 
-      // No child matches the input `watched` object: consider the event as not filtered.
-      return false;
+      return !child->second->widget->hasKeyboardFocus();
     }
 
     bool
     SdlWidget::focusInEvent(const engine::FocusEvent& e) {
-      verbose(
-        "Handling focus in from " + e.getEmitter()->getName() + " with reason " + std::to_string(static_cast<int>(e.getReason())) + " (policy: " + getFocusPolicy().toString() + ")"
-      );
+      lazyLog<LogLevel::Verbose>([&]() {
+        return
+          "Handling focus in from " + e.getEmitter()->getName() + " with reason " + std::to_string(static_cast<int>(e.getReason())) + " (policy: " + getFocusPolicy().toString() + ")"
+        ;
+      });
 
       // A focus in event has been raised with a specific reason. The first step
       // in processing this event is to actually determine whether this widget is
@@ -304,7 +419,7 @@ namespace sdl {
       // though.
       if (!hasKeyboardFocus() && canCauseKeyboardFocusChange(e.getReason())) {
         // Notify that we should receive the keyboard focus.
-        postEvent(std::make_shared<engine::Event>(engine::Event::Type::KeyboardGrabbed));
+        postEvent(EventsPool::create<engine::Event>(engine::Event::Type::KeyboardGrabbed));
       }
 
       // Handle focusing of children if needed: we only want to do so if we can't
@@ -344,7 +459,7 @@ namespace sdl {
 
     bool
     SdlWidget::focusOutEvent(const engine::FocusEvent& e) {
-      verbose("Handling focus out from " + e.getEmitter()->getName() + " with reason " + std::to_string(static_cast<int>(e.getReason())));
+      lazyLog<LogLevel::Verbose>([&]() { return "Handling focus out from " + e.getEmitter()->getName() + " with reason " + std::to_string(static_cast<int>(e.getReason())); });
 
       // A focus out event has been raised with a specific reason. The process to
       // follow is very similar to the one used in `focusInEvent` except the event
@@ -369,7 +484,7 @@ namespace sdl {
       // the keyboard status. If this is the case we make this widget lose the focus.
       if (hasKeyboardFocus() && canCauseKeyboardFocusChange(e.getReason())) {
         // Post an event indicating that we just lost keyboard focus.
-        postEvent(std::make_shared<engine::Event>(engine::Event::Type::KeyboardReleased));
+        postEvent(EventsPool::create<engine::Event>(engine::Event::Type::KeyboardReleased));
       }
 
       // Perform an update of the internal state of this widget. We can safely call
@@ -398,10 +513,12 @@ namespace sdl {
       // now focus.
       // We also need to focus ourselves so that the chain of widgets
       // which lead to the deepest focused child can be built.
-      verbose(
-        "Handling gain focus from " + e.getEmitter()->getName() +
-        " with reason " + std::to_string(static_cast<int>(e.getReason()))
-      );
+      lazyLog<LogLevel::Verbose>([&]() {
+        return
+          "Handling gain focus from " + e.getEmitter()->getName() +
+          " with reason " + std::to_string(static_cast<int>(e.getReason()))
+        ;
+      });
 
       // Apply the focus modification if needed: we also optimize a bit
       // by checking whether the event is produced by `this` widget: if
@@ -430,7 +547,7 @@ namespace sdl {
           // Update the keyboard focus: as we're handling a gain focus event
           // which has not been produced by `this` widget we need to set the
           // keyboard focus to `false`.
-          postEvent(std::make_shared<engine::Event>(engine::Event::Type::KeyboardReleased));
+          postEvent(EventsPool::create<engine::Event>(engine::Event::Type::KeyboardReleased));
         }
       }
 
@@ -440,10 +557,10 @@ namespace sdl {
         const std::lock_guard guard(m_childrenLocker);
         for (WidgetsMap::const_iterator child = m_children.cbegin() ; child != m_children.cend() ; ++child) {
 
-          verbose("Child " + child->widget->getName() + (child->widget->hasFocus() ? " has " : " has not ") + "focus");
+          lazyLog<LogLevel::Verbose>([&]() { return "Child " + child->widget->getName() + (child->widget->hasFocus() ? " has " : " has not ") + "focus"; });
           // If the child is not the source of the event and is focused, unfocus it.
           if (!e.isEmittedBy(child->widget) && child->widget->hasFocus()) {
-            verbose("Posting focus out event on " + child->widget->getName() + " due to " + e.getEmitter()->getName() + " gaining focus");
+            lazyLog<LogLevel::Verbose>([&]() { return "Posting focus out event on " + child->widget->getName() + " due to " + e.getEmitter()->getName() + " gaining focus"; });
             postEvent(engine::FocusEvent::createFocusOutEvent(e.getReason(), isEmitter(e), child->widget), false);
           }
         }
@@ -477,20 +594,55 @@ namespace sdl {
 
     bool
     SdlWidget::keyPressEvent(const engine::KeyEvent& e) {
-      // Check whether the event corresponds to a tab key.
-      if (e.getRawKey() == engine::RawKey::Tab) {
-        // Use the dedicated handler after protecting from concurrent accesses.
-        const std::lock_guard guard(m_childrenLocker);
-
-        focusNextChild(engine::shiftEnabled(e.getModifiers()));
+      // Check whether the event corresponds to a tab key. The event might be
+      // received by several widgets of the hierarchy: only the one holding the
+      // keyboard focus (or the root if no widget holds it) moves the focus.
+      if (e.getRawKey() == engine::RawKey::Tab &&
+          (hasKeyboardFocus() || (!hasParent() && m_keyboardChild == nullptr)))
+      {
+        focusNextInRing(engine::shiftEnabled(e.getModifiers()));
       }
 
       return LayoutItem::keyPressEvent(e);
     }
 
+    bool
+    SdlWidget::keyboardGrabbedEvent(const engine::Event& e) {
+      // Register the path from the root of the hierarchy to this widget.
+      SdlWidget* child = this;
+      SdlWidget* parent = m_parent;
+
+      while (parent != nullptr) {
+        parent->m_keyboardChild = child;
+
+        child = parent;
+        parent = parent->m_parent;
+      }
+
+      // Use the base handler to update the keyboard focus status.
+      return LayoutItem::keyboardGrabbedEvent(e);
+    }
+
+    bool
+    SdlWidget::keyboardReleasedEvent(const engine::Event& e) {
+      // Unregister this widget from the keyboard focus path: we stop as soon
+      // as an ancestor refers to another child as another widget might have
+      // grabbed the keyboard focus in the meantime.
+      SdlWidget* child = this;
+      SdlWidget* parent = m_parent;
+
+      while (parent != nullptr && parent->m_keyboardChild.compare_exchange_strong(child, nullptr)) {
+        child = parent;
+        parent = parent->m_parent;
+      }
+
+      // Use the base handler to update the keyboard focus status.
+      return LayoutItem::keyboardReleasedEvent(e);
+    }
+
     bool
     SdlWidget::lostFocusEvent(const engine::FocusEvent& e) {
-      verbose("Handling lost focus from " + e.getEmitter()->getName());
+      lazyLog<LogLevel::Verbose>([&]() { return "Handling lost focus from " + e.getEmitter()->getName(); });
 
       // A lost focus event comes after a leave event and means that the
       // focus has been removed from this widget. It also means that no
@@ -500,10 +652,10 @@ namespace sdl {
         const std::lock_guard guard(m_childrenLocker);
         for (WidgetsMap::const_iterator child = m_children.cbegin() ; child != m_children.cend() ; ++child) {
 
-          verbose("Child " + child->widget->getName() + (child->widget->hasFocus() ? " has " : " has not ") + "focus");
+          lazyLog<LogLevel::Verbose>([&]() { return "Child " + child->widget->getName() + (child->widget->hasFocus() ? " has " : " has not ") + "focus"; });
           // If the child is not the source of the event and is focused, unfocus it.
           if (child->widget->hasFocus()) {
-            verbose("Posting focus out event on " + child->widget->getName() + " due to " + getName() + " losing focus");
+            lazyLog<LogLevel::Verbose>([&]() { return "Posting focus out event on " + child->widget->getName() + " due to " + getName() + " losing focus"; });
             postEvent(engine::FocusEvent::createFocusOutEvent(e.getReason(), isEmitter(e), child->widget), false);
           }
         }
@@ -551,6 +703,13 @@ namespace sdl {
       // Note that we assume here that when an event comes from a
       // widget it at least contains all its area.
 
+      // Textureless widgets are drawn directly in the content of
+      // their parent: the event should be forwarded to it.
+      if (isTextureless()) {
+        forwardRepaint(e);
+        return LayoutItem::repaintEvent(e);
+      }
+
       // Compare both timestamps and see whether we need to
       // consider this event or if we can safely trash it.
       if (m_repaint >= e.getTimestamp()) {
@@ -564,15 +723,19 @@ namespace sdl {
         // repainted after the last time we drew it completely so
         // we can use this event to update things.
         if (!e.isSpontaneous()) {
-          const std::string name = e.getEmitter()->getName();
-
           // Retrieve the internal timestamp if any.
-          RepaintMap::const_iterator lastRepaint = m_childrenRepaints.find(name);
+          bool repainted = false;
+          {
+            const std::lock_guard guard(m_childrenLocker);
+
+            EmittersMap::const_iterator child = m_emitters.find(e.getEmitter());
+            repainted = (child != m_emitters.cend() && child->second->repaint >= e.getTimestamp());
+          }
 
-          if (lastRepaint != m_childrenRepaints.cend() && lastRepaint->second >= e.getTimestamp()) {
+          if (repainted) {
             // We repainted this widget after the event has been emitted,
             // no need to paint it again.
-            verbose("Trashing repaint from " + e.getEmitter()->getName() + " posterior to last refresh");
+            lazyLog<LogLevel::Verbose>([&]() { return "Trashing repaint from " + e.getEmitter()->getName() + " posterior to last refresh"; });
 
             // Use base handler to provide a return value.
             return LayoutItem::repaintEvent(e);
@@ -581,9 +744,13 @@ namespace sdl {
       }
 
       // If no previous repaint operations were registered, we need to
-      // create a new one.
+      // create a new one. In any case we need to notify the ancestors
+      // that a graphic operation is pending for this widget so that it
+      // is reached during the next `draw` call.
+      markSubtreeDirty();
+
       if (m_repaintOperation == nullptr) {
-        m_repaintOperation = std::make_shared<engine::PaintEvent>(e);
+        m_repaintOperation = EventsPool::create<engine::PaintEvent>(e);
       }
       else {
         // Might happen if events are posted faster than the repaint from
@@ -609,6 +776,12 @@ namespace sdl {
       // Use the base handler to handle the resize.
       const bool toReturn = LayoutItem::resizeEvent(e);
 
+      // When called by a layout pass the repaint of the widget is
+      // registered by the pass itself.
+      if (isApplyingGeometry()) {
+        return toReturn;
+      }
+
       // We should clear the existing repaint events, as
       // the sizes associated to them have probably become
       // obsolete due to the resize event.
@@ -637,6 +810,238 @@ namespace sdl {
       return toReturn;
     }
 
+    void
+    SdlWidget::layoutSynchronously(const utils::Boxf& area) {
+      // The pass might be started from an event handler of this widget or
+      // reach a widget processing an event: in this case the locker is
+      // already held by this thread.
+      const ContentGuard guard(*this);
+
+      const utils::Sizef old = LayoutItem::getRenderingArea().toSize();
+
+      // Run the base handler: the internal layout will be updated in the
+      // same pass through `updatePrivate`.
+      m_synchronousLayout = true;
+      LayoutItem::layoutSynchronously(area);
+      m_synchronousLayout = false;
+
+      // The geometry of this widget is now up-to-date.
+      m_deferredGeometry = false;
+
+      // Similarly to what happens in `resizeEvent` the pending repaint
+      // operations are now obsolete. Rather than posting a new repaint we
+      // directly register a repaint of the whole widget which will be run
+      // during the next `draw`: the children are laid out already so they
+      // will be drawn at their final position. The parent is in charge of
+      // blitting this widget at its new position.
+      removeEvents(engine::Event::Type::Repaint);
+
+      if (old != area.toSize()) {
+        m_contentDirty = true;
+      }
+
+      m_repaintOperation.reset();
+
+      const utils::Boxf local = LayoutItem::getRenderingArea();
+      if (local.valid()) {
+        m_repaintOperation = EventsPool::create<engine::PaintEvent>(mapToGlobal(local, false));
+        m_repaintOperation->setEmitter(this);
+      }
+
+      markSubtreeDirty();
+    }
+
+    void
+    SdlWidget::resumeUpdates() {
+      unsigned count = m_updatesSuspended.load();
+      do {
+        if (count == 0u) {
+          error(
+            std::string("Cannot resume updates"),
+            std::string("Updates are not suspended")
+          );
+        }
+      }
+      while (!m_updatesSuspended.compare_exchange_weak(count, count - 1u));
+
+      if (count > 1u) {
+        return;
+      }
+
+      --m_suspendedWidgets;
+
+      // In case an ancestor still suspends the updates, transfer the pending
+      // updates to it: they will be performed with the rest of its hierarchy.
+      SdlWidget* suspender = getUpdatesSuspender();
+      if (suspender != nullptr) {
+        if (m_pendingGeometry.exchange(false)) {
+          suspender->m_pendingGeometry = true;
+        }
+        if (m_pendingRepaint.exchange(false)) {
+          suspender->m_pendingRepaint = true;
+        }
+
+        return;
+      }
+
+      flushDeferredUpdates();
+    }
+
+    bool
+    SdlWidget::deferUpdate(bool geometry) noexcept {
+      SdlWidget* suspender = getUpdatesSuspender();
+      if (suspender == nullptr) {
+        return false;
+      }
+
+      if (geometry) {
+        m_deferredGeometry = true;
+        suspender->m_pendingGeometry = true;
+      }
+      else {
+        m_deferredRepaint = true;
+        suspender->m_pendingRepaint = true;
+      }
+
+      return true;
+    }
+
+    void
+    SdlWidget::flushDeferredUpdates() {
+      const bool geometry = m_pendingGeometry.exchange(false);
+      const bool repaint = m_pendingRepaint.exchange(false);
+
+      if (!geometry && !repaint) {
+        return;
+      }
+
+      // The layout pass marks the geometry of this widget as up-to-date but
+      // the manager of this widget is not part of the pass: if the geometry
+      // of this widget itself was invalidated it should still be notified.
+      const bool deferred = m_deferredGeometry.exchange(false);
+
+      // Lay out the whole hierarchy in a single pass: this registers the
+      // repaint of all the widgets reached through the layouts.
+      const utils::Boxf area = LayoutItem::getRenderingArea();
+      const bool laidOut = (geometry && area.valid());
+
+      if (laidOut) {
+        layoutSynchronously(area);
+      }
+
+      if (deferred) {
+        if (laidOut) {
+          if (isManaged()) {
+            LayoutItem::makeGeometryDirty();
+          }
+        }
+        else {
+          // The root was not laid out: fall back to the usual process.
+          makeGeometryDirty();
+        }
+      }
+
+      // Handle the widgets which were not reached by the layout pass.
+      flushDeferredUpdatesOf(this);
+
+      m_deferredGeometry = false;
+      m_deferredRepaint = false;
+
+      // A single repaint is enough to display the whole hierarchy.
+      requestRepaint();
+    }
+
+    void
+    SdlWidget::flushDeferredUpdatesOf(const SdlWidget* root) {
+      if (this != root) {
+        if (m_deferredGeometry.exchange(false)) {
+          makeGeometryDirty();
+        }
+
+        if (m_deferredRepaint.exchange(false) && !isTextureless()) {
+          const ContentGuard guard(*this);
+
+          const utils::Boxf local = LayoutItem::getRenderingArea();
+          if (local.valid()) {
+            const engine::PaintEvent pe(mapToGlobal(local, false));
+
+            if (m_repaintOperation == nullptr) {
+              m_repaintOperation = EventsPool::create<engine::PaintEvent>(pe);
+            }
+            else {
+              m_repaintOperation->merge(pe);
+            }
+            m_repaintOperation->setEmitter(this);
+
+            markSubtreeDirty();
+          }
+        }
+      }
+
+      const std::lock_guard guard(m_childrenLocker);
+      for (WidgetsMap::const_iterator child = m_children.cbegin() ; child != m_children.cend() ; ++child) {
+        child->widget->flushDeferredUpdatesOf(root);
+      }
+    }
+
+    std::vector<utils::Boxf>
+    SdlWidget::commitGeometry(const GeometryChange& change) {
+      const ContentGuard guard(*this);
+
+      // Keep track of the old area: it needs to be converted before the
+      // new area is assigned as the conversion uses it.
+      const bool wasVisible = isVisible();
+      const utils::Boxf old = LayoutItem::getRenderingArea();
+      const utils::Boxf oldGlobal = (old.valid() ? mapToGlobal(old, false) : utils::Boxf());
+
+      LayoutItem::commitGeometry(change);
+
+      const bool visible = isVisible();
+      const utils::Boxf area = LayoutItem::getRenderingArea();
+
+      if (wasVisible == visible && old == area) {
+        return std::vector<utils::Boxf>();
+      }
+
+      // Similarly to what happens in `resizeEvent` the pending repaint
+      // operations are now obsolete. The repaint of the whole widget is
+      // registered directly instead of being posted.
+      removeEvents(engine::Event::Type::Repaint);
+      m_repaintOperation.reset();
+
+      std::vector<utils::Boxf> regions;
+      if (wasVisible && oldGlobal.valid()) {
+        regions.push_back(oldGlobal);
+      }
+
+      if (!visible || !area.valid()) {
+        return regions;
+      }
+
+      if (!wasVisible || old.toSize() != area.toSize()) {
+        m_contentDirty = true;
+      }
+
+      const utils::Boxf global = mapToGlobal(area, false);
+      regions.push_back(global);
+
+      m_repaintOperation = EventsPool::create<engine::PaintEvent>(global);
+      m_repaintOperation->setEmitter(this);
+
+      markSubtreeDirty();
+
+      return regions;
+    }
+
+    void
+    SdlWidget::updateSynchronously(const utils::Boxf& area) {
+      // Lay out the whole hierarchy and then request a single repaint for
+      // this widget: it will redraw the children in their final position.
+      layoutSynchronously(area);
+
+      requestRepaint();
+    }
+
     bool
     SdlWidget::zOrderChanged(const engine::Event& e) {
       const std::lock_guard guard(m_childrenLocker);
@@ -647,7 +1052,7 @@ namespace sdl {
         // Transmit to the parent if any.
         if (hasParent()) {
           postEvent(
-            std::make_shared<engine::Event>(engine::Event::Type::ZOrderChanged, m_parent),
+            EventsPool::create<engine::Event>(engine::Event::Type::ZOrderChanged, m_parent),
             false
           );
         }
@@ -655,26 +1060,35 @@ namespace sdl {
         return LayoutItem::zOrderChanged(e);
       }
 
-      // We will assume that the event comes from one of our children. Note
-      // that we will not preventively check that it is the case: the most
-      // important part is to prevent the rebuild of the z ordering if nothing
-      // changed which will be handled afterwards.
+      // We will assume that the event comes from one of our children. In
+      // case we can identify it only this child needs to be moved: otherwise
+      // we check all the children. The most important part is to prevent the
+      // invalidation of the z ordering if nothing changed.
+      ChildrenMap::iterator source = m_names.end();
+      if (!e.isSpontaneous()) {
+        EmittersMap::const_iterator emitter = m_emitters.find(e.getEmitter());
+
+        if (emitter != m_emitters.cend()) {
+          source = m_names.find(emitter->second->name);
+        }
+      }
 
       // Let us be pessimistic.
       bool changed = false;
 
-      // Traverse the children list and updtae the z order for each one.
-      for (WidgetsMap::iterator child = m_children.begin() ; child != m_children.end() ; ++child) {
-        const int newZOrder = child->widget->getZOrder();
-        if (newZOrder != child->zOrder) {
-          changed = true;
+      if (source != m_names.end()) {
+        changed = updateChildZOrder(source);
+      }
+      else {
+        for (ChildrenMap::iterator child = m_names.begin() ; child != m_names.end() ; ++child) {
+          changed = updateChildZOrder(child) || changed;
         }
-        child->zOrder = newZOrder;
       }
 
-      // Proceed to rebuild the z ordering if needed.
+      // The stacking order of the children changed: caches relying on it
+      // should be refreshed.
       if (changed) {
-        rebuildZOrdering();
+        invalidateGeometryEpoch();
       }
 
       // Use the base handler method to provide a return value.
@@ -682,19 +1096,23 @@ namespace sdl {
     }
 
     void
-    SdlWidget::refreshPrivate(const engine::PaintEvent& e) {
+    SdlWidget::refreshPrivate(const engine::PaintEvent& e,
+                              const Region& damaged)
+    {
       // Replace the cached content.
       const std::lock_guard guard(m_cacheLocker);
 
       // Create a new cached texture if the size of the cached content is
-      // different from the current size of the content.
+      // different from the current size of the content. Textures might be
+      // larger than the widget when they come from the pool: the part which
+      // is actually used is defined by the rendering area.
       utils::Sizef old;
       if (m_cachedContent.valid()) {
         old = getEngine().queryTexture(m_cachedContent);
       }
-      utils::Sizef cur = getEngine().queryTexture(m_content);
+      const utils::Sizef cur = LayoutItem::getRenderingArea().toSize();
 
-      if (!m_cachedContent.valid() || old != cur) {
+      if (!m_cachedContent.valid() || old != getEngine().queryTexture(m_content)) {
         // Clear existing cached texture.
         clearCachedTexture();
 
@@ -704,18 +1122,28 @@ namespace sdl {
         // In order to make the texture valid for rendering we need to clear it
         // with a valid color.
         getEngine().fillTexture(m_cachedContent, getPalette());
+
+        // Copy the data of `m_content` onto `m_cachedContent`: only
+        // the part used by the widget is relevant.
+        const utils::Boxf used = convertToEngineFormat(utils::Boxf(0.0f, 0.0f, cur.w(), cur.h()), cur);
+        getEngine().drawTexture(m_content, &used, &m_cachedContent, &used);
       }
       else {
-        // Clear content so that we do not get polluted by the remains of old
-        // renderings.
-        clearContentPrivate(m_cachedContent, utils::Boxf::fromSize(old, true));
+        // The cached content is still valid outside of the parts which have
+        // just been repainted: only copy these. We need to clear each part
+        // first so that we do not get polluted by the remains of old renderings.
+        // As both textures have the same size the source and destination areas
+        // are identical.
+        const Region::Rectangles& rects = damaged.getRectangles();
+
+        for (Region::Rectangles::const_iterator rect = rects.cbegin() ; rect != rects.cend() ; ++rect) {
+          clearContentPrivate(m_cachedContent, *rect);
+
+          const utils::Boxf area = convertToEngineFormat(*rect, cur);
+          getEngine().drawTexture(m_content, &area, &m_cachedContent, &area);
+        }
       }
 
-      // Copy the data of `m_content` onto `m_cachedContent`.
-      // We can copy withtout specifying dimensions as both
-      // textures should have similar sizes.
-      getEngine().drawTexture(m_content, nullptr, &m_cachedContent);
-
       // Update the last repaint which just took place right now.
       m_repaint = std::chrono::steady_clock::now();
 
@@ -741,7 +1169,7 @@ namespace sdl {
       const utils::Boxf toRepaint = mapToGlobal(local);
 
       // Once we have the coordinates, create the paint event.
-      engine::PaintEventShPtr pe = std::make_shared<engine::PaintEvent>(toRepaint);
+      engine::PaintEventShPtr pe = EventsPool::create<engine::PaintEvent>(toRepaint);
       pe->setEmitter(this);
 
       // Don't forget to add the input paint regions. We need to do that only if
@@ -749,7 +1177,7 @@ namespace sdl {
       // example we don't really need to notify the parent widget that a region
       // has been updated if it is the one which told us in the first place.
       // The copy is handled on the fly when building the output event.
-      if (!e.isSpontaneous() && (isEmitter(e) || hasChild(e.getEmitter()->getName()))) {
+      if (!e.isSpontaneous() && (isEmitter(e) || isChild(e.getEmitter()))) {
         pe->copyUpdateRegions(e);
       }
 
@@ -839,12 +1267,20 @@ namespace sdl {
       // To do so we need to update the content of `this` widget in the input
       // update areas but also redraw the children which intersect these
       // locations.
-      // Not that in order to redraw only what's really necessary we process
-      // for each region in a single pass both the update of `this` widget's
-      // content and the update of the children intersecting this area.
+      // The regions of the event might overlap or be adjacent (typically when
+      // several paint events were merged): in order to process each pixel only
+      // once we first gather them in a single region made of non-overlapping
+      // rectangles. If the content has been recreated the whole area of the
+      // widget should be repainted.
       const std::vector<engine::update::Region> regions = e.getUpdateRegions();
 
       utils::Sizef dims = area.toSize();
+      const utils::Boxf local = utils::Boxf::fromSize(dims, true);
+
+      Region toUpdate;
+      if (redraw) {
+        toUpdate.add(local);
+      }
 
       for (unsigned id = 0u ; id < regions.size() ; ++id) {
         // Convert the region from global to local coordinate frame if needed.
@@ -854,114 +1290,154 @@ namespace sdl {
           regions[id].area
         );
 
-        verbose(
-          "Updating region " + region.toString() + " from " + regions[id].toString() +
-          " (ref: " + area.toString() + ") (source: " + e.getEmitter()->getName() + ")"
-        );
+        lazyLog<LogLevel::Verbose>([&]() {
+          return
+            "Updating region " + region.toString() + " from " + regions[id].toString() +
+            " (ref: " + area.toString() + ") (source: " + e.getEmitter()->getName() + ")"
+          ;
+        });
 
-        // Update the content of `this` widget: first clear the content and
-        // then perform the draw operation.
-        clearContentPrivate(m_content, region);
-        drawContentPrivate(m_content, region);
+        toUpdate.add(region);
+      }
 
-        // Now iterate over children and draw them if needed (i.e. if they
-        // intersect the current area).
-        {
-          const std::lock_guard guard(m_childrenLocker);
+      // Nothing outside of the area of the widget can be displayed.
+      toUpdate.clip(local);
+      toUpdate.coalesce();
 
-          for (WidgetsMap::const_iterator child = m_children.cbegin() ; child != m_children.cend() ; ++child) {
-            // The child needs to be repainted if:
-            // 1. It is visible.
-            // 2. It needs a repaint from the input `event`.
-            // 3. It needs a repaint because the widget has been recreated.
+      m_repaintRegions += regions.size();
+      m_repaintRectangles += toUpdate.size();
 
-            // If the widget is not visible, skip this part entirely.
-            if (!child->widget->isVisible()) {
-              continue;
-            }
+      const Region::Rectangles& rects = toUpdate.getRectangles();
 
-            // Determine whether this widget intersect the current update region.
-            const utils::Boxf childBox = child->widget->getRenderingArea();
-            utils::Boxf dst = region.intersect(childBox);
-            utils::Boxf dstEngine = convertToEngineFormat(dst, area);
-
-            // If this widget does not intersect the current region, do nothing.
-            // This behavior is overriden by the `redraw` boolean which indicates
-            // that as `this` widget has been recreated we will repaint children
-            // no matter what.
-            if (!dst.valid() && !redraw) {
-              continue;
-            }
+      const std::lock_guard guard(m_childrenLocker);
 
-            // Determine the source area by converting the `dst` area into
-            // the widget's coordinate frame.
-            const utils::Boxf src = convertToLocal(dst, childBox);
-            const utils::Boxf srcEngine = convertToEngineFormat(src, childBox);
+      // Determine which parts of each child are actually visible: children
+      // are sorted by ascending z order so we traverse them backwards and
+      // accumulate the areas covered by opaque children. Anything below
+      // these areas does not need to be drawn at all.
+      std::vector<Region> visible(m_children.size());
+      std::vector<utils::Boxf> occluders;
 
-            verbose(
-              "Drawing child " + child->widget->getName() + " (src: " + src.toString() + ", dst: " + dst.toString() + "), intersect with " + region.toString()
-            );
-            drawWidget(*child->widget, srcEngine, dstEngine);
+      unsigned id = m_children.size();
+      for (WidgetsMap::const_reverse_iterator it = m_children.crbegin() ; it != m_children.crend() ; ++it) {
+        --id;
 
-            // Update the repaint timestamp for this child if the area contains
-            // the child's area.
-            if (region.contains(childBox)) {
-              m_childrenRepaints[child->widget->getName()] = std::chrono::steady_clock::now();
-            }
-          }
+        const SdlWidget* child = it->widget;
+        if (!child->isVisible()) {
+          continue;
+        }
+
+        const utils::Boxf childBox = child->getRenderingArea();
+
+        for (Region::Rectangles::const_iterator rect = rects.cbegin() ; rect != rects.cend() ; ++rect) {
+          visible[id].add(rect->intersect(childBox));
+        }
+
+        const bool touched = !visible[id].empty();
+        for (std::vector<utils::Boxf>::const_iterator occ = occluders.cbegin() ; occ != occluders.cend() ; ++occ) {
+          visible[id].subtract(*occ);
+        }
+
+        if (touched && visible[id].empty()) {
+          ++m_occludedChildren;
+        }
+
+        if (child->isOpaque()) {
+          occluders.push_back(childBox);
         }
       }
 
-      const std::lock_guard guard(m_childrenLocker);
+      // Update the content of `this` widget: first clear the content and then
+      // perform the draw operation. As rectangles do not overlap we can handle
+      // all of them before drawing the children. The parts covered by opaque
+      // children are skipped.
+      Region exposed = toUpdate;
+      for (std::vector<utils::Boxf>::const_iterator occ = occluders.cbegin() ; occ != occluders.cend() ; ++occ) {
+        exposed.subtract(*occ);
+      }
+
+      const Region::Rectangles& contentRects = exposed.getRectangles();
+      for (Region::Rectangles::const_iterator rect = contentRects.cbegin() ; rect != contentRects.cend() ; ++rect) {
+        clearContentPrivate(m_content, *rect);
+        drawContentPrivate(m_content, *rect);
+      }
+
+      // Now iterate over children and draw their visible parts. Each part of
+      // a child is blitted at most once as the rectangles do not overlap. We
+      // still need to process children in ascending z order so that children
+      // which are not opaque are correctly blended over the ones below them.
+      id = 0u;
+      for (WidgetsMap::const_iterator it = m_children.cbegin() ; it != m_children.cend() ; ++it, ++id) {
+        SdlWidget* child = it->widget;
+
+        // If the widget is not visible, skip this part entirely.
+        if (!child->isVisible()) {
+          continue;
+        }
+
+        const utils::Boxf childBox = child->getRenderingArea();
+        const bool textureless = child->isTextureless();
+
+        const Region::Rectangles& parts = visible[id].getRectangles();
+        for (Region::Rectangles::const_iterator dst = parts.cbegin() ; dst != parts.cend() ; ++dst) {
+          // Textureless children are directly filled in our content.
+          if (textureless) {
+            drawTexturelessWidget(*child, childBox, *dst, dims);
+            continue;
+          }
+
+          utils::Boxf dstEngine = convertToEngineFormat(*dst, area);
+
+          // Determine the source area by converting the `dst` area into
+          // the widget's coordinate frame.
+          const utils::Boxf src = convertToLocal(*dst, childBox);
+          const utils::Boxf srcEngine = convertToEngineFormat(src, childBox);
+
+          lazyLog<LogLevel::Verbose>([&]() {
+            return
+              "Drawing child " + child->getName() + " (src: " + src.toString() + ", dst: " + dst->toString() + ")"
+            ;
+          });
+          drawWidget(*child, srcEngine, dstEngine);
+        }
+
+        // Update the repaint timestamp for this child if the updated area
+        // contains the child's area.
+        if (toUpdate.contains(childBox)) {
+          it->repaint = std::chrono::steady_clock::now();
+        }
+      }
 
       // Finally let's handle the repaint of the source of the repaint event
       // if it is not part of our children. This allows to actually display
       // elements on top of other widgets.
-      if (!e.isSpontaneous() && !hasChild(e.getEmitter()->getName()) && !isEmitter(e)) {
+      if (!e.isSpontaneous() && !isChild(e.getEmitter()) && !isEmitter(e)) {
         // Check whether the emitter can be displayed as a widget.
         SdlWidget* source = dynamic_cast<SdlWidget*>(e.getEmitter());
 
         if (source != nullptr) {
-          // Draw all the repaint regions mentionned in the event using the
-          // `source` of the event as repaint base.
-          // For each area described in the paint event we need to compute
-          // its intersection with `this` object: from that we can derive
-          // the `src` area to repaint. The `dst` area corresponds to the
-          // local conversion of the `regions[id]` box. Strictly speaking we
-          // could handle the intersection of this area with the dimensions
-          // of `this` widget's area in order to only blit relevant parts
-          // of the `source` object.
+          // Draw all the updated rectangles using the `source` of the event
+          // as repaint base. The rectangles are already expressed in local
+          // coordinate frame and restricted to `this` widget's area: the
+          // `dst` area is thus the rectangle converted into engine format
+          // and the `src` area is the rectangle expressed in the `source`
+          // coordinate frame.
           const utils::Boxf global = source->getDrawingArea();
 
-          for (unsigned id = 0u ; id < regions.size() ; ++id) {
-            // Convert the input region expressed in global coordinate frame
-            // into local frame if needed.
-            const utils::Boxf region = (
-              regions[id].frame == engine::update::Frame::Global ?
-              mapFromGlobal(regions[id].area) :
-              regions[id].area
-            );
-
-            // The `dst` region of the repaint area corresponds to this region
-            // converted into engine format. Indeed the `region` is already in
-            // local coordinate frame.
-            const utils::Boxf interD = utils::Boxf::fromSize(dims, true).intersect(region);
-            const utils::Boxf dst = convertToEngineFormat(interD, dims);
+          for (Region::Rectangles::const_iterator rect = rects.cbegin() ; rect != rects.cend() ; ++rect) {
+            const utils::Boxf dst = convertToEngineFormat(*rect, dims);
 
-            // Compute the intersection of the regions with `this` object's
-            // area and convert it to global coordinate frame.
-            const utils::Boxf inter = utils::Boxf::fromSize(dims, true).intersect(region);
-            const utils::Boxf interG = mapToGlobal(inter);
+            const utils::Boxf interG = mapToGlobal(*rect);
             const utils::Boxf src = convertToLocal(interG, global);
 
-            info("Drawing " + source->getName() + " from " + src.toString() + " to " + dst.toString() + " (raw: " + interD.toString() + ")");
+            lazyLog<LogLevel::Info>([&]() { return "Drawing " + source->getName() + " from " + src.toString() + " to " + dst.toString() + " (raw: " + rect->toString() + ")"; });
             drawWidgetOn(*source, m_content, src, dst);
           }
         }
       }
 
       // Now perform the refresh operation.
-      refreshPrivate(e);
+      refreshPrivate(e, toUpdate);
     }
 
     void
@@ -983,93 +1459,384 @@ namespace sdl {
         },
         std::string("drawWidget(") + widget.getName() + ")"
       );
+
+      // Account for the widgets visited while drawing the child.
+      m_drawVisits += widget.m_drawVisits;
     }
 
     void
-    SdlWidget::drawWidgetOn(SdlWidget& widget,
-                            const utils::Uuid& on,
-                            const utils::Boxf& src,
-                            const utils::Boxf& dst)
+    SdlWidget::drawTexturelessWidget(SdlWidget& widget,
+                                     const utils::Boxf& box,
+                                     const utils::Boxf& region,
+                                     const utils::Sizef& dims)
     {
-      bool span = false;
+      engine::Engine& engine = getEngine();
 
-      // Protect against errors.
-      withSafetyNet(
-        [&widget, &on, &src, &dst, &span]() {
-          // Display the widget on the input texture at the specified coordinates.
-          span = widget.drawOn(on, &src, &dst);
-        },
-        std::string("drawWidgetOn(") + widget.getName() + ")"
-      );
+      // Fill the region with the color of the widget: we temporarily use
+      // its fill role on our own content to do so.
+      const engine::Palette::ColorRole role = engine.getTextureRole(m_content);
+      const utils::Boxf regionEngine = convertToEngineFormat(region, dims);
 
-      if (!span) {
-        // Note that we can end up here in several situations. One of them being that
-        // the widget to repaint used to span the `dst` area but doesn't anymore. In
-        // this case the job is already done because what was really needed was to
-        // repaint the content of `this` widget at the specified `dst` area so that
-        // it erases the old and now irrelevant content of the `widget` which used to
-        // span the area. In this case the warning message is not really important.
-        warn("Widget " + widget.getName() + " does not seem to span area " + src.toString());
-      }
-    }
+      engine.setTextureRole(m_content, widget.m_fillRole);
+      engine.fillTexture(m_content, widget.getPalette(), &regionEngine);
+      engine.setTextureRole(m_content, role);
 
-    void
-    SdlWidget::rebuildZOrdering() {
-      // First we need to sort the internal `m_children` array.
-      // Note that we want the items to be sorted in ascending
-      // order of their z order.
-      // Indeed as larger values of z order indicates widgets
-      // in front of others, this is the correct behavior to
-      // adopt. The sort should compare `lhs` less than `rhs`
-      // based on their z order.
-      std::sort(m_children.begin(), m_children.end(),
-        [](const ChildWrapper& lhs, const ChildWrapper& rhs) {
-          return lhs.zOrder < rhs.zOrder;
+      ++m_drawVisits;
+
+      // Draw the children of the widget on top of it. Their areas are
+      // expressed in the local frame of `widget` so we need to offset
+      // them with its position in our own frame.
+      const std::lock_guard guard(widget.m_childrenLocker);
+
+      for (WidgetsMap::const_iterator child = widget.m_children.cbegin() ; child != widget.m_children.cend() ; ++child) {
+        if (!child->widget->isVisible()) {
+          continue;
+        }
+
+        const utils::Boxf area = child->widget->getRenderingArea();
+        const utils::Boxf childBox(box.x() + area.x(), box.y() + area.y(), area.w(), area.h());
+
+        const utils::Boxf dst = region.intersect(childBox);
+        if (!dst.valid()) {
+          continue;
         }
-      );
 
-      // Now rebuild the internal `m_names` array.
-      m_names.clear();
+        if (child->widget->isTextureless()) {
+          drawTexturelessWidget(*child->widget, childBox, dst, dims);
+          continue;
+        }
 
-      for (int id = 0 ; id < getChildrenCount() ; ++id) {
-        m_names[m_children[id].widget->getName()] = id;
+        drawWidget(
+          *child->widget,
+          convertToEngineFormat(convertToLocal(dst, childBox), childBox),
+          convertToEngineFormat(dst, dims)
+        );
       }
     }
 
-    bool
-    SdlWidget::focusNextChild(bool reverse) {
-      // Determine which one of the child has the focus and cycle to the
-      // next one which can handle focus.
-      // In case no child has the focus yet we will start at the first
-      // one and if no children can handle a `Tab` focus we will just
-      // stop the processing here.
-      bool focus = false;
-      unsigned id = 0;
-      TabOrdering::const_iterator it = m_tabOrder.cbegin();
+    void
+    SdlWidget::forwardRepaint(const engine::PaintEvent& e) {
+      // Only forward events which concern this widget: the parent already
+      // receives the events from other widgets on its own.
+      {
+        const std::lock_guard guard(m_childrenLocker);
+        if (!e.isSpontaneous() && !isEmitter(e) && !isChild(e.getEmitter())) {
+          return;
+        }
+      }
 
-      while (it != m_tabOrder.cend() && focus == false) {
-        // Attempt to retrieve the corresponding child.
-        ChildrenMap::const_iterator ch = m_names.find(*it);
+      // Convert the regions to global coordinate frame and gather them in a
+      // single event to send to the parent.
+      const std::vector<engine::update::Region> regions = e.getUpdateRegions();
+      engine::PaintEventShPtr pe = nullptr;
 
-        if (ch == m_names.cend()) {
-          // Should not happen but it does not hurt to remove the corresponding
-          // item in the tab ordering.
-          warn("Found widget \"" + *it + "\" without associated child, removing it");
+      for (unsigned id = 0u ; id < regions.size() ; ++id) {
+        const utils::Boxf global = (
+          regions[id].frame == engine::update::Frame::Local ?
+          mapToGlobal(regions[id].area) :
+          regions[id].area
+        );
 
-          it = m_tabOrder.erase(it);
+        if (pe == nullptr) {
+          pe = EventsPool::create<engine::PaintEvent>(global);
         }
         else {
-          // Fetch the child and check whether it has focus.
-          const ChildWrapper& child = m_children[ch->second];
-          focus = child.widget->hasKeyboardFocus();
+          pe->merge(engine::PaintEvent(global));
+        }
+      }
 
-          if (!focus) {
-            ++it;
-            ++id;
+      if (pe == nullptr) {
+        return;
+      }
+
+      pe->setEmitter(this);
+      pe->setReceiver(m_parent);
+
+      postEvent(pe, false, false);
+    }
+
+    void
+    SdlWidget::drawWidgetOn(SdlWidget& widget,
+                            const utils::Uuid& on,
+                            const utils::Boxf& src,
+                            const utils::Boxf& dst)
+    {
+      bool span = false;
+
+      // Protect against errors.
+      withSafetyNet(
+        [&widget, &on, &src, &dst, &span]() {
+          // Display the widget on the input texture at the specified coordinates.
+          span = widget.drawOn(on, &src, &dst);
+        },
+        std::string("drawWidgetOn(") + widget.getName() + ")"
+      );
+
+      if (!span) {
+        // Note that we can end up here in several situations. One of them being that
+        // the widget to repaint used to span the `dst` area but doesn't anymore. In
+        // this case the job is already done because what was really needed was to
+        // repaint the content of `this` widget at the specified `dst` area so that
+        // it erases the old and now irrelevant content of the `widget` which used to
+        // span the area. In this case the warning message is not really important.
+        warn("Widget " + widget.getName() + " does not seem to span area " + src.toString());
+      }
+    }
+
+    void
+    SdlWidget::addWidgets(const std::vector<SdlWidget*>& widgets) {
+      // Check all the widgets before modifying anything.
+      {
+        const std::lock_guard guard(m_childrenLocker);
+
+        std::unordered_set<NamesTable::Handle> names;
+
+        for (std::vector<SdlWidget*>::const_iterator widget = widgets.cbegin() ; widget != widgets.cend() ; ++widget) {
+          if (*widget == nullptr) {
+            error(std::string("Cannot add null widget"));
+          }
+
+          if ((*widget)->hasParent()) {
+            error(
+              std::string("Cannot add widget \"") + (*widget)->getName() + "\"",
+              std::string("Widget already has a parent")
+            );
+          }
+
+          if (m_names.find((*widget)->m_nameId) != m_names.cend() ||
+              !names.insert((*widget)->m_nameId).second)
+          {
+            error(std::string("Cannot add duplicated widget \"") + (*widget)->getName() + "\"");
           }
         }
       }
 
+      // Register this widget as the parent of each widget and share the
+      // data with them.
+      for (std::vector<SdlWidget*>::const_iterator widget = widgets.cbegin() ; widget != widgets.cend() ; ++widget) {
+        (*widget)->m_parent = this;
+        (*widget)->invalidateGlobalOffset();
+
+        // The widgets are not roots anymore.
+        delete (*widget)->m_focusRing.exchange(nullptr);
+
+        shareData(*widget);
+        (*widget)->installEventFilter(this);
+      }
+
+      // Sort the widgets once by ascending z order: in the common case
+      // each one is then inserted after all the existing children.
+      std::vector<SdlWidget*> sorted(widgets);
+      std::stable_sort(sorted.begin(), sorted.end(),
+        [](const SdlWidget* lhs, const SdlWidget* rhs) {
+          return lhs->getZOrder() < rhs->getZOrder();
+        }
+      );
+
+      {
+        const std::lock_guard guard(m_childrenLocker);
+
+        for (std::vector<SdlWidget*>::const_iterator widget = sorted.cbegin() ; widget != sorted.cend() ; ++widget) {
+          insertChild(*widget);
+        }
+      }
+
+      // The position of the widgets in the global coordinate frame and the
+      // stacking order of the children changed.
+      invalidateGeometryEpoch();
+
+      for (std::vector<SdlWidget*>::const_iterator widget = widgets.cbegin() ; widget != widgets.cend() ; ++widget) {
+        (*widget)->registerInFocusRing();
+      }
+    }
+
+    void
+    SdlWidget::insertChild(SdlWidget* widget) {
+      const unsigned order = m_childrenOrder++;
+      widget->m_childOrder = order;
+
+      // The insertion order is larger than the one of all the existing
+      // children so in the common case of a z order larger or equal to the
+      // one of the existing children, the child is inserted at the end.
+      WidgetsMap::iterator child = m_children.emplace_hint(
+        m_children.end(),
+        widget,
+        widget->getZOrder(),
+        order,
+        widget->m_nameId
+      );
+
+      m_names[widget->m_nameId] = child;
+      m_emitters[widget] = child;
+      m_tabOrder.emplace_hint(m_tabOrder.end(), order, child);
+
+      // Register the child in the spatial index.
+      itemHitAreaChanged(*widget);
+    }
+
+    const LayoutItem*
+    SdlWidget::resolveMouseTarget(const utils::Vector2f& pos) const noexcept {
+      // Traverse the hierarchy up to the root: this is the only widget
+      // actually performing the hit test.
+      const SdlWidget* root = this;
+      while (root->m_parent != nullptr) {
+        root = root->m_parent;
+      }
+
+      return root->LayoutItem::resolveMouseTarget(pos);
+    }
+
+    bool
+    SdlWidget::isChild(const engine::EngineObject* object) const noexcept {
+      return m_emitters.find(object) != m_emitters.cend();
+    }
+
+    bool
+    SdlWidget::updateChildZOrder(ChildrenMap::iterator child) {
+      const int zOrder = child->second->widget->getZOrder();
+      if (zOrder == child->second->zOrder) {
+        return false;
+      }
+
+      // Move the child to its new position without reallocating it.
+      WidgetsMap::node_type node = m_children.extract(child->second);
+      node.value().zOrder = zOrder;
+      child->second = m_children.insert(std::move(node)).position;
+
+      // The insertion order is not modified so the entry in the tab ordering
+      // can be accessed directly.
+      m_tabOrder[child->second->order] = child->second;
+      m_emitters[child->second->widget] = child->second;
+
+      // The priority of the child in the spatial index changed.
+      itemHitAreaChanged(*child->second->widget);
+
+      return true;
+    }
+
+    void
+    SdlWidget::refreshHitIndex() const {
+      // Retrieve the children queued so far: the queue is swapped with the
+      // refresh buffer so that both keep their storage. Children notifying
+      // from now on will be queued again.
+      {
+        const std::lock_guard guard(m_hitUpdatesLocker);
+
+        if (m_hitUpdates.empty()) {
+          return;
+        }
+
+        for (std::vector<const LayoutItem*>::const_iterator child = m_hitUpdates.cbegin() ; child != m_hitUpdates.cend() ; ++child) {
+          markHitAreaPending(**child, false);
+        }
+
+        std::swap(m_hitUpdates, m_hitRefresh);
+      }
+
+      for (std::vector<const LayoutItem*>::const_iterator item = m_hitRefresh.cbegin() ; item != m_hitRefresh.cend() ; ++item) {
+        EmittersMap::const_iterator child = m_emitters.find(*item);
+        if (child == m_emitters.cend()) {
+          continue;
+        }
+
+        const SdlWidget* widget = child->second->widget;
+
+        if (!widget->isVisible()) {
+          m_hitIndex.remove(widget);
+          continue;
+        }
+
+        m_hitIndex.update(widget, widget->getHitArea(), std::make_pair(child->second->zOrder, child->second->order));
+      }
+
+      m_hitRefresh.clear();
+    }
+
+    void
+    SdlWidget::removeFromHitIndex(const SdlWidget* child) {
+      m_hitIndex.remove(child);
+
+      const std::lock_guard guard(m_hitUpdatesLocker);
+
+      if (markHitAreaPending(*child, false)) {
+        m_hitUpdates.erase(std::find(m_hitUpdates.begin(), m_hitUpdates.end(), child));
+      }
+    }
+
+    void
+    SdlWidget::areaChanged() {
+      // The position of this widget and of all its descendants changed.
+      invalidateGlobalOffset();
+    }
+
+    void
+    SdlWidget::invalidateGlobalOffset() {
+      {
+        const std::lock_guard guard(m_hierarchyLocker);
+
+        if (!m_globalOffsetValid) {
+          return;
+        }
+
+        m_globalOffsetValid = false;
+      }
+
+      // The lock is released before traversing the children: a child might
+      // be computing its offset from the one of this widget.
+      const std::lock_guard guard(m_childrenLocker);
+
+      for (WidgetsMap::const_iterator child = m_children.cbegin() ; child != m_children.cend() ; ++child) {
+        child->widget->invalidateGlobalOffset();
+      }
+    }
+
+    void
+    SdlWidget::hitAreaChanged() {
+      // Children are indexed by their parent: the layout of the parent does
+      // not perform any hit test.
+      if (hasParent()) {
+        m_parent->itemHitAreaChanged(*this);
+        return;
+      }
+
+      LayoutItem::hitAreaChanged();
+    }
+
+    void
+    SdlWidget::itemHitAreaChanged(const LayoutItem& item) {
+      {
+        const std::lock_guard guard(m_hitUpdatesLocker);
+
+        // In case the child is already queued, the parent of this widget was
+        // already notified as well.
+        if (markHitAreaPending(item, true)) {
+          return;
+        }
+
+        m_hitUpdates.push_back(&item);
+      }
+
+      // The hit area of this widget depends on the one of its children.
+      hitAreaChanged();
+    }
+
+    bool
+    SdlWidget::focusNextChild(bool reverse) {
+      // Determine which one of the child has the focus and cycle to the
+      // next one which can handle focus.
+      // In case no child has the focus yet we will start at the first
+      // one and if no children can handle a `Tab` focus we will just
+      // stop the processing here.
+      // The child having the focus is registered in the keyboard focus path:
+      // it might also refer to a child which only contains the focused widget
+      // in which case we behave as if no child had the focus.
+      TabOrdering::const_iterator it = m_tabOrder.cend();
+
+      EmittersMap::const_iterator focused = m_emitters.find(m_keyboardChild.load());
+      if (focused != m_emitters.cend() && focused->second->widget->hasKeyboardFocus()) {
+        it = m_tabOrder.find(focused->second->order);
+      }
+
       // Check whether we could find a child with the focus.
       bool canHandle = false;
       SdlWidget* wid = nullptr;
@@ -1077,16 +1844,11 @@ namespace sdl {
       if (it == m_tabOrder.cend()) {
         // No child currently has the focus: traverse the list and try to
         // find the first one which can handle such a focus.
-        id = 0u;
+        TabOrdering::const_iterator id = m_tabOrder.cbegin();
 
-        while (id < m_tabOrder.size() && !canHandle) {
-          // We assume that the name can be found because we checked it in
-          // the previous loop0
-          ChildrenMap::const_iterator ch = m_names.find(m_tabOrder[id]);
-          const ChildWrapper& child = m_children[ch->second];
-
-          canHandle = child.widget->canHandleFocusReason(engine::FocusEvent::Reason::TabFocus);
-          wid = child.widget;
+        while (id != m_tabOrder.cend() && !canHandle) {
+          canHandle = id->second->widget->canHandleFocusReason(engine::FocusEvent::Reason::TabFocus);
+          wid = id->second->widget;
           if (!canHandle) {
             ++id;
           }
@@ -1095,30 +1857,28 @@ namespace sdl {
       else {
         // We need to find either the next or previous child which can handle the
         // focus (depending on whether the shift modifier is pressed).
-        unsigned cur = id;
-        unsigned size = m_tabOrder.size();
+        const TabOrdering::const_iterator cur = it;
 
-        auto toNext = [&reverse, &size](unsigned id) {
+        auto toNext = [this, &reverse](TabOrdering::const_iterator id) {
           if (reverse) {
-            return (id - 1 + size) % size;
-          }
-          else {
-            return (id + 1) % size;
+            if (id == m_tabOrder.cbegin()) {
+              id = m_tabOrder.cend();
+            }
+
+            return --id;
           }
+
+          ++id;
+          return (id == m_tabOrder.cend() ? m_tabOrder.cbegin() : id);
         };
 
-        id = toNext(id);
+        TabOrdering::const_iterator id = toNext(cur);
 
         // Loop until we reach the current id again or until we find a suitable
         // other child.
         while (id != cur && !canHandle) {
-          // We assume that the name can be found because we checked it in
-          // the previous loop0
-          ChildrenMap::const_iterator ch = m_names.find(m_tabOrder[id]);
-          const ChildWrapper& child = m_children[ch->second];
-
-          canHandle = child.widget->canHandleFocusReason(engine::FocusEvent::Reason::TabFocus);
-          wid = child.widget;
+          canHandle = id->second->widget->canHandleFocusReason(engine::FocusEvent::Reason::TabFocus);
+          wid = id->second->widget;
           if (!canHandle) {
             id = toNext(id);
           }
@@ -1156,5 +1916,362 @@ namespace sdl {
       return canHandle;
     }
 
+    bool
+    SdlWidget::focusNextInRing(bool reverse) {
+      // The focus ring is held by the root of the hierarchy.
+      SdlWidget* root = this;
+      while (root->m_parent != nullptr) {
+        root = root->m_parent;
+      }
+
+      FocusRing& ring = root->getFocusRing();
+
+      {
+        const std::lock_guard guard(ring.locker);
+
+        // Register the move after the ones which are still pending so that
+        // they are performed in the order in which they were requested.
+        ring.pendingMoves.push_back(reverse);
+      }
+
+      // The ring is usually up to date. In case it is stale and cannot be
+      // rebuilt right now the move will be done during the next `draw` of
+      // the root.
+      if (!root->rebuildFocusRing(ring, false)) {
+        return false;
+      }
+
+      return root->performFocusMoves(ring, this);
+    }
+
+    void
+    SdlWidget::updateFocusRing() {
+      FocusRing& ring = getFocusRing();
+
+      // Most frames neither need to rebuild the ring nor to move the focus.
+      {
+        const std::lock_guard guard(ring.locker);
+
+        if (!ring.stale && ring.pendingMoves.empty()) {
+          return;
+        }
+      }
+
+      if (!rebuildFocusRing(ring, true)) {
+        return;
+      }
+
+      // The moves start from the widget holding the keyboard focus or from
+      // the root if there's none, just like when a `Tab` is received.
+      const SdlWidget* from = this;
+      SdlWidget* next = m_keyboardChild;
+
+      while (next != nullptr && !from->hasKeyboardFocus()) {
+        from = next;
+        next = next->m_keyboardChild;
+      }
+
+      if (!from->hasKeyboardFocus()) {
+        from = this;
+      }
+
+      performFocusMoves(ring, from);
+    }
+
+    SdlWidget::FocusRing&
+    SdlWidget::getFocusRing() {
+      FocusRing* ring = m_focusRing.load();
+      if (ring != nullptr) {
+        return *ring;
+      }
+
+      FocusRing* created = new FocusRing{FocusMembers(), true, 0u, std::vector<bool>(), {}};
+
+      // Another thread might have allocated the ring in the meantime: in
+      // this case we use its version.
+      if (!m_focusRing.compare_exchange_strong(ring, created)) {
+        delete created;
+        return *ring;
+      }
+
+      return *created;
+    }
+
+    bool
+    SdlWidget::performFocusMoves(FocusRing& ring,
+                                 const SdlWidget* from)
+    {
+      // Locate the starting widget before locking the ring.
+      FocusPath path;
+      from->computeFocusPath(path);
+
+      SdlWidget* target = nullptr;
+      bool reverse = false;
+
+      {
+        const std::lock_guard guard(ring.locker);
+
+        // The ring might have been invalidated since it was rebuilt: the
+        // moves are kept for the next rebuild in this case.
+        if (ring.stale) {
+          return false;
+        }
+
+        // Widgets which are not members of the ring are located between the
+        // members surrounding them in traversal order.
+        FocusMembers::const_iterator it = ring.members.upper_bound(path);
+        bool member = (it != ring.members.cbegin() && std::prev(it)->second == from);
+
+        for (std::vector<bool>::const_iterator move = ring.pendingMoves.cbegin() ;
+             move != ring.pendingMoves.cend() && !ring.members.empty() ;
+             ++move)
+        {
+          reverse = *move;
+
+          if (reverse) {
+            // Step back over the current widget if it is a member.
+            if (member) {
+              --it;
+            }
+            if (it == ring.members.cbegin()) {
+              it = ring.members.cend();
+            }
+            --it;
+          }
+          else {
+            if (it == ring.members.cend()) {
+              it = ring.members.cbegin();
+            }
+          }
+
+          target = it->second;
+
+          // The next move starts from the member reached by this one.
+          ++it;
+          member = true;
+        }
+
+        ring.pendingMoves.clear();
+      }
+
+      // Nothing to do if no other widget can receive the focus.
+      if (target == nullptr || target == from) {
+        return false;
+      }
+
+      engine::FocusEvent::Reason r =
+        reverse ?
+        engine::FocusEvent::Reason::BacktabFocus :
+        engine::FocusEvent::Reason::TabFocus
+      ;
+
+      postEvent(engine::FocusEvent::createFocusInEvent(r, true, target));
+
+      return true;
+    }
+
+    bool
+    SdlWidget::rebuildFocusRing(FocusRing& ring,
+                                bool wait)
+    {
+      unsigned revision = 0u;
+
+      {
+        const std::lock_guard guard(ring.locker);
+
+        if (!ring.stale) {
+          return true;
+        }
+
+        revision = ring.revision;
+      }
+
+      // Collect the members without holding the lock on the ring: updates
+      // performed in the meantime are detected through the revision.
+      FocusPath path;
+      FocusMembers members;
+
+      if (!collectFocusMembers(this, path, members, wait)) {
+        return false;
+      }
+
+      const std::lock_guard guard(ring.locker);
+
+      // The ring might have been rebuilt concurrently.
+      if (!ring.stale) {
+        return true;
+      }
+      if (ring.revision != revision) {
+        return false;
+      }
+
+      ring.members.swap(members);
+      ring.stale = false;
+
+      return true;
+    }
+
+    bool
+    SdlWidget::collectFocusMembers(SdlWidget* widget,
+                                   FocusPath& path,
+                                   FocusMembers& members,
+                                   bool wait)
+    {
+      if (widget->canHandleFocusReason(engine::FocusEvent::Reason::TabFocus)) {
+        members.emplace(path, widget);
+      }
+
+      // Register the children in tab order.
+      std::unique_lock guard(widget->m_childrenLocker, std::defer_lock);
+      if (wait) {
+        guard.lock();
+      }
+      else if (!guard.try_lock()) {
+        return false;
+      }
+
+      bool built = true;
+      for (TabOrdering::const_iterator child = widget->m_tabOrder.cbegin() ; child != widget->m_tabOrder.cend() && built ; ++child) {
+        path.push_back(child->first);
+        built = collectFocusMembers(child->second->widget, path, members, wait);
+        path.pop_back();
+      }
+
+      return built;
+    }
+
+    const SdlWidget*
+    SdlWidget::computeFocusPath(FocusPath& path) const {
+      path.clear();
+
+      const SdlWidget* widget = this;
+      while (widget->m_parent != nullptr) {
+        path.push_back(widget->m_childOrder);
+        widget = widget->m_parent;
+      }
+
+      // The orders were collected from this widget up to the root.
+      std::reverse(path.begin(), path.end());
+
+      return widget;
+    }
+
+    void
+    SdlWidget::registerInFocusRing() {
+      FocusPath path;
+      FocusRing* ring = computeFocusPath(path)->m_focusRing.load();
+
+      // Nothing to do if the ring is not built yet: it will include this
+      // widget when it is.
+      if (ring == nullptr) {
+        return;
+      }
+
+      try {
+        // Collect the members of the subtree before locking the ring as it
+        // is never held while acquiring another lock.
+        FocusMembers members;
+        collectFocusMembers(this, path, members, true);
+
+        const std::lock_guard guard(ring->locker);
+        ++ring->revision;
+
+        if (!ring->stale) {
+          for (FocusMembers::const_iterator member = members.cbegin() ; member != members.cend() ; ++member) {
+            ring->members[member->first] = member->second;
+          }
+        }
+      }
+      catch (...) {
+        // The ring is missing some widgets: rebuild it entirely.
+        const std::lock_guard guard(ring->locker);
+        ring->stale = true;
+        ++ring->revision;
+
+        throw;
+      }
+    }
+
+    void
+    SdlWidget::unregisterFromFocusRing() noexcept {
+      const SdlWidget* root = this;
+      while (root->m_parent != nullptr) {
+        root = root->m_parent;
+      }
+
+      FocusRing* ring = root->m_focusRing.load();
+      if (ring == nullptr) {
+        return;
+      }
+
+      try {
+        FocusPath path;
+        computeFocusPath(path);
+
+        const std::lock_guard guard(ring->locker);
+        ++ring->revision;
+
+        // The members of the subtree of this widget have paths starting with
+        // the path of this widget: they are contiguous in the ring.
+        FocusMembers::iterator first = ring->members.lower_bound(path);
+        FocusMembers::iterator last = first;
+
+        while (last != ring->members.end() &&
+               last->first.size() >= path.size() &&
+               std::equal(path.cbegin(), path.cend(), last->first.cbegin()))
+        {
+          ++last;
+        }
+
+        ring->members.erase(first, last);
+      }
+      catch (...) {
+        // The ring might reference this widget: rebuild it entirely.
+        const std::lock_guard guard(ring->locker);
+        ring->stale = true;
+        ++ring->revision;
+      }
+    }
+
+    void
+    SdlWidget::focusPolicyChanged() noexcept {
+      const SdlWidget* root = this;
+      while (root->m_parent != nullptr) {
+        root = root->m_parent;
+      }
+
+      FocusRing* ring = root->m_focusRing.load();
+      if (ring == nullptr) {
+        return;
+      }
+
+      try {
+        FocusPath path;
+        computeFocusPath(path);
+
+        const bool member = canHandleFocusReason(engine::FocusEvent::Reason::TabFocus);
+
+        const std::lock_guard guard(ring->locker);
+        ++ring->revision;
+
+        if (ring->stale) {
+          return;
+        }
+
+        if (member) {
+          ring->members[path] = this;
+        }
+        else {
+          ring->members.erase(path);
+        }
+      }
+      catch (...) {
+        // The ring could not be updated: rebuild it entirely.
+        const std::lock_guard guard(ring->locker);
+        ring->stale = true;
+        ++ring->revision;
+      }
+    }
+
   }
 }
@@ -1,9 +1,15 @@
 #ifndef    SDLWIDGET_HH
 # define   SDLWIDGET_HH
 
+# include <map>
+# include <set>
 # include <mutex>
+# include <atomic>
 # include <chrono>
+# include <exception>
 # include <memory>
+# include <thread>
+# include <vector>
 # include <unordered_map>
 
 # include <maths_utils/Box.hh>
@@ -21,7 +27,11 @@
 
 # include "Layout.hh"
 # include "LayoutItem.hh"
+# include "NamesTable.hh"
+# include "Region.hh"
 # include "SizePolicy.hh"
+# include "SpatialIndex.hh"
+# include "TexturePool.hh"
 
 namespace sdl {
   namespace core {
@@ -79,6 +89,17 @@ namespace sdl {
         std::string
         getZOrderString(const LayoutItem* stop = nullptr) const noexcept override;
 
+        /**
+         * @brief - Reimplementation of the parent `LayoutItem` method which allows to
+         *          account for the `z` order of the ancestors of this widget. The key is
+         *          cached and only rebuilt when the geometry epoch changes, which happens
+         *          among other things when the `z` order of any item is modified.
+         * @return - a key describing the successive `z` orders of the ancestors of this
+         *           widget.
+         */
+        ZOrderKey
+        getZOrderKey() const noexcept override;
+
         void
         setLayout(std::shared_ptr<Layout> layout) noexcept;
 
@@ -88,9 +109,64 @@ namespace sdl {
         void
         setPalette(const engine::Palette& palette) noexcept;
 
+        /**
+         * @brief - Assigns the engine used to create and draw the textures of this widget
+         *          and of its children. Any implementation of the `engine::Engine` can be
+         *          used: in particular a `SoftwareEngine` renders the whole hierarchy in
+         *          memory, which allows to run widgets without any display.
+         * @param engine - the engine to assign to this widget.
+         */
         void
         setEngine(engine::EngineShPtr engine) noexcept;
 
+        /**
+         * @brief - Used to determine whether this widget is drawn without any texture of
+         *          its own. In this mode the widget is represented as a rectangle filled
+         *          with the color of its palette directly into the content of its parent
+         *          along with its children.
+         *          Note that a widget without a parent always uses textures, no matter the
+         *          value of the flag set through `setTextureless`.
+         * @return - `true` if this widget is drawn without textures.
+         */
+        bool
+        isTextureless() const noexcept;
+
+        /**
+         * @brief - Allows to define whether this widget should be drawn without its own
+         *          textures. This is suited for widgets which do not reimplement the method
+         *          `drawContentPrivate` and are thus only a filled rectangle with children
+         *          (typically container panels): it saves the memory used by the textures
+         *          and the copies needed to draw them into the parent.
+         *          Switching to textureless releases the existing textures of the widget.
+         * @param textureless - `true` if the widget should be drawn without textures.
+         */
+        void
+        setTextureless(bool textureless);
+
+        /**
+         * @brief - Assigns the input area to this widget and lays out its whole hierarchy in
+         *          a single pass: the nested layouts are computed recursively and the areas
+         *          of all the children are assigned directly, without going through the
+         *          events queue. A single repaint is requested once the pass is complete.
+         *          This method can be called from an event handler of this widget or of
+         *          any of its descendants (e.g. from a click callback): the content of the
+         *          widgets already locked by the calling thread is not locked again.
+         * @param area - the new area of the widget.
+         */
+        void
+        updateSynchronously(const utils::Boxf& area);
+
+        /**
+         * @brief - Retrieves the texture pool used by this widget to create its textures.
+         *          The pool is created when an engine is assigned to a widget and shared
+         *          with all its children. It can be used to configure the memory cap of
+         *          the pool or to retrieve statistics about it.
+         * @return - the texture pool used by this widget or `null` if no engine has been
+         *           assigned to the widget yet.
+         */
+        TexturePoolShPtr
+        getTexturePool() const noexcept;
+
         /**
          * @brief - Used to retrieve the identifier of the texture representing the
          *          content for this widget. If no valid identifier is available for
@@ -111,13 +187,55 @@ namespace sdl {
          *          be updated.
          *          Failure to draw the widget will raise an error.
          *          The return value corresponds to the index of the texture representing
-         *          this widget.
+         *          this widget. Note that textures are recycled by size classes so that the
+         *          texture might be larger than the widget: only the top left part matching
+         *          the size of the rendering area is relevant. Use `drawOn` to draw it.
          * @return - the index of the texture which has been produced by the drawing
          *           operation.
          */
         virtual utils::Uuid
         draw();
 
+        /**
+         * @brief - Retrieves the number of widgets which were visited during the last call
+         *          to `draw` on this widget, including this widget itself. Subtrees which
+         *          do not have any pending graphic operations are skipped by the `draw`
+         *          method so this value gives an indication of how much of the hierarchy
+         *          needed to be traversed to produce the last frame.
+         *          Note that widgets drawn as part of the repaint of their parent are also
+         *          accounted for.
+         * @return - the number of widgets visited during the last `draw` operation.
+         */
+        unsigned
+        getDrawVisitsCount() const noexcept;
+
+        /**
+         * @brief - Retrieves the total number of update regions received through paint
+         *          events and processed by this widget since its creation. Compared with
+         *          the value returned by `getRepaintRectanglesCount` it indicates how much
+         *          overlapping or adjacent regions were merged before repainting.
+         * @return - the number of update regions processed by this widget.
+         */
+        unsigned
+        getRepaintRegionsCount() const noexcept;
+
+        /**
+         * @brief - Retrieves the total number of non-overlapping rectangles which have
+         *          actually been repainted by this widget since its creation, once the
+         *          update regions of each paint event have been merged and coalesced.
+         * @return - the number of rectangles repainted by this widget.
+         */
+        unsigned
+        getRepaintRectanglesCount() const noexcept;
+
+        /**
+         * @brief - Retrieves the total number of times a child intersecting an update area
+         *          was skipped because it was entirely covered by opaque siblings.
+         * @return - the number of child repaints avoided by this widget.
+         */
+        unsigned
+        getOccludedChildrenCount() const noexcept;
+
         /**
          * @brief - Attempts to draw the content of this widget on the provided `on` texture
          *          at the destination `dst`. The source area is represented using `src` arg
@@ -168,6 +286,19 @@ namespace sdl {
         void
         setParent(SdlWidget* parent);
 
+        /**
+         * @brief - Assigns this widget as the parent of all the input `widgets` in a single
+         *          operation: the children are inserted at once rather than one by one so
+         *          that the ordering of the children is only updated once.
+         *          Note that unlike `setParent` the `addWidget` method is not called for
+         *          each widget: inheriting classes which specialize it should not rely on
+         *          this method. Raises an error if any of the widgets is null, already has
+         *          a parent or has the same name as another child.
+         * @param widgets - the widgets to add as children of this widget.
+         */
+        void
+        addWidgets(const std::vector<SdlWidget*>& widgets);
+
         /**
          * @brief - Reimplementation of the base `LayoutItem` method which allows to provide
          *          the deepest widget spanning the input position. The item is returned
@@ -183,6 +314,102 @@ namespace sdl {
         const SdlWidget*
         getItemAt(const utils::Vector2f& pos) const noexcept override;
 
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to provide the area where
+         *          this widget or any of its descendants can be hit. This area is expressed in
+         *          the local frame of the parent (or in window's coordinate frame for top level
+         *          widgets) and might be larger than the drawing area of the widget in case some
+         *          children are displayed outside of it (as it happens for a combobox for example).
+         *          The children only contribute through the bounds of the spatial index: moving
+         *          this widget does not require to update the index.
+         * @return - the area where the hierarchy defined by this widget can be hit.
+         */
+        utils::Boxf
+        getHitArea() const noexcept override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to indicate whether this
+         *          widget was declared opaque through `setOpaque` and is visible.
+         * @return - `true` if this widget is opaque.
+         */
+        bool
+        isOpaque() const noexcept override;
+
+        /**
+         * @brief - Allows to declare this widget as opaque: it indicates that the content of
+         *          the widget fills its whole area with no transparency. Siblings located
+         *          below an opaque widget are not repainted in the parts it covers.
+         *          Widgets which use a palette with transparent colors or which do not draw
+         *          their whole area should not be declared opaque.
+         * @param opaque - `true` if this widget is opaque.
+         */
+        void
+        setOpaque(bool opaque);
+
+        /**
+         * @brief - Suspends the updates of this widget and of all its descendants: calls to
+         *          `requestRepaint`, `makeContentDirty` and `makeGeometryDirty` do not post
+         *          any event but are registered until the outermost suspension ends. At this
+         *          point a single layout pass is performed for the whole hierarchy and a
+         *          single repaint is requested for this widget.
+         *          Suspensions can be nested: each call should be matched by a call to the
+         *          `resumeUpdates` method. Most users should use the `UpdatesBlocker` class.
+         *          If the geometry of this widget itself was invalidated in the meantime its
+         *          manager (if any) is notified once the hierarchy has been laid out.
+         */
+        void
+        suspendUpdates() noexcept;
+
+        /**
+         * @brief - Ends a suspension started with `suspendUpdates`. If this was the last one
+         *          and no ancestor of this widget suspends its updates, the updates which were
+         *          registered in the meantime are performed.
+         *          This method can be called while processing an event of this widget: the
+         *          layout pass does not lock the widgets already locked by the calling thread.
+         *          Raises an error if the updates of this widget are not suspended.
+         */
+        void
+        resumeUpdates();
+
+        /**
+         * @brief - Used to determine whether the updates of this widget are suspended, either
+         *          because of a call to `suspendUpdates` on this widget or on any ancestor.
+         * @return - `true` if the updates of this widget are suspended.
+         */
+        bool
+        areUpdatesSuspended() const noexcept;
+
+        /**
+         * @brief - Convenience class which suspends the updates of a widget for its whole
+         *          lifetime. Typical use is when building or restyling large hierarchies.
+         */
+        class UpdatesBlocker {
+          public:
+
+            /**
+             * @brief - Suspends the updates of the input `widget` until this object is
+             *          destroyed.
+             * @param widget - the widget for which updates should be suspended.
+             */
+            explicit
+            UpdatesBlocker(SdlWidget& widget) noexcept;
+
+            /**
+             * @brief - Resumes the updates of the widget. Errors raised while performing the
+             *          deferred updates are logged and not propagated.
+             */
+            ~UpdatesBlocker() noexcept;
+
+            UpdatesBlocker(const UpdatesBlocker&) = delete;
+
+            UpdatesBlocker&
+            operator=(const UpdatesBlocker&) = delete;
+
+          private:
+
+            SdlWidget& m_widget;
+        };
+
       protected:
 
         /**
@@ -237,6 +464,52 @@ namespace sdl {
         void
         updatePrivate(const utils::Boxf& window) override;
 
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to lay out the internal
+         *          layout of this widget in the same pass. No repaint event is posted: the
+         *          repaint of the whole widget is registered directly and processed during
+         *          the next `draw` call.
+         * @param area - the new area of the widget.
+         */
+        void
+        layoutSynchronously(const utils::Boxf& area) override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to register a repaint of
+         *          this widget in a similar way to `layoutSynchronously` when the area or the
+         *          visibility of the widget changes. The returned regions cover both the old
+         *          and the new area of the widget so that the container can repaint them.
+         * @param change - the modifications to apply to this widget.
+         * @return - the regions to repaint in the container of the layout.
+         */
+        std::vector<utils::Boxf>
+        commitGeometry(const GeometryChange& change) override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to invalidate the global
+         *          offset of this widget and of its descendants.
+         */
+        void
+        areaChanged() override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to notify the parent of
+         *          this widget if any: children are indexed by their parent and not by the
+         *          layout of the parent. Top level widgets notify their manager.
+         */
+        void
+        hitAreaChanged() override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to queue the input child
+         *          for a refresh of its entry in the spatial index of this widget. The parent
+         *          of this widget is notified in turn as the hit area of this widget depends
+         *          on the one of its children.
+         * @param item - the child which changed.
+         */
+        void
+        itemHitAreaChanged(const LayoutItem& item) override;
+
         /**
          * @brief - Reimplementation of the base `LayoutItem` method. This method is
          *          meant to provide custom behavior when upon transmitting keyboard
@@ -249,7 +522,31 @@ namespace sdl {
          */
         bool
         filterKeyboardEvents(const engine::EngineObject* watched,
-                             const engine::KeyEventShPtr e) const noexcept override;
+                             const engine::KeyEvent& e) const noexcept override;
+
+        using LayoutItem::filterKeyboardEvents;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method to add this widget to or
+         *          remove it from the focus ring of its hierarchy when it can respectively
+         *          start or stop receiving the focus with a `Tab`.
+         */
+        void
+        focusPolicyChanged() noexcept override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method. Every widget of a
+         *          hierarchy watching a mouse event used to perform its own hit test
+         *          from its position in the hierarchy. As the root of the hierarchy is
+         *          always part of the filters applied to any widget, its result is the
+         *          one deciding which widget receives the event: the target is thus
+         *          resolved (and memorized) once by the root and shared by all the
+         *          widgets.
+         * @param pos - the position of the mouse event.
+         * @return - the deepest widget of the hierarchy spanning the position.
+         */
+        const LayoutItem*
+        resolveMouseTarget(const utils::Vector2f& pos) const noexcept override;
 
         /**
          * @brief - Specialization of the base `EngineObject` method to allow a lock operation
@@ -293,6 +590,25 @@ namespace sdl {
         bool
         keyPressEvent(const engine::KeyEvent& e) override;
 
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method. Registers this widget as
+         *          the end of the keyboard focus path of its ancestors: each of them then knows
+         *          which of its children leads to the widget holding the keyboard focus.
+         * @param e - the event to be interpreted.
+         * @return - `true` if the event was recognized, `false` otherwise.
+         */
+        bool
+        keyboardGrabbedEvent(const engine::Event& e) override;
+
+        /**
+         * @brief - Reimplementation of the base `LayoutItem` method. Removes this widget from
+         *          the keyboard focus path of its ancestors if it is still registered there.
+         * @param e - the event to be interpreted.
+         * @return - `true` if the event was recognized, `false` otherwise.
+         */
+        bool
+        keyboardReleasedEvent(const engine::Event& e) override;
+
         bool
         lostFocusEvent(const engine::FocusEvent& e) override;
 
@@ -413,7 +729,8 @@ namespace sdl {
 
         /**
          * @brief - Returns true if this widget has a child of any kind with a
-         *          name matching the input string.
+         *          name matching the input string. The name is resolved through
+         *          the names table so that no string is hashed for the children.
          *          Note that this method assumes that the `m_childrenLocker`
          *          mutex is already acquired.
          * @param name - the name of the child which should be searched.
@@ -423,6 +740,19 @@ namespace sdl {
         bool
         hasChild(const std::string& name) const noexcept;
 
+        /**
+         * @brief - Returns true if the input widget is a child of this widget. The
+         *          identifier of the name of the widget is used directly so that no
+         *          access to the names table is needed.
+         *          Note that this method assumes that the `m_childrenLocker`
+         *          mutex is already acquired.
+         * @param widget - the widget which should be searched.
+         * @return - `true` if the `widget` is a child of this widget and `false`
+         *           otherwise.
+         */
+        bool
+        hasChild(const SdlWidget* widget) const noexcept;
+
         /**
          * @brief - Try to retrieve the child with a name corresponding to the input
          *          string as a pointer to the specified object type.
@@ -523,6 +853,17 @@ namespace sdl {
         utils::Boxf
         mapFromGlobal(const utils::Boxf& global) const noexcept;
 
+        /**
+         * @brief - Retrieves the position of the center of this widget expressed in global
+         *          coordinate frame. This value accounts for the position of this widget in
+         *          its parent and for the offset of all its ancestors.
+         *          The value is cached and only recomputed when the geometry epoch changes
+         *          so that mapping coordinates does not need to traverse the ancestors.
+         * @return - the global offset of this widget.
+         */
+        utils::Vector2f
+        getGlobalOffset() const noexcept;
+
         /**
          * @brief - Used to convert the input box expressed in relative coordinate frame
          *          relatively to this widget into an area expressed in a coordinate frame
@@ -618,9 +959,15 @@ namespace sdl {
          *          method focuses on notifying parent elements of the
          *          event and also rebuilding the cached content from the
          *          now up-to-date content.
+         *          Only the `damaged` parts of the content are copied to
+         *          the cached content unless it needs to be recreated.
+         * @param e - the paint event which triggered the refresh.
+         * @param damaged - the parts of the content which have been
+         *                  repainted, expressed in local coordinate frame.
          */
         void
-        refreshPrivate(const engine::PaintEvent& e);
+        refreshPrivate(const engine::PaintEvent& e,
+                       const Region& damaged);
 
         /**
          * @brief - The specialization of the `repaintEvent` which is called
@@ -648,6 +995,8 @@ namespace sdl {
          *          The user can specify the role with which the texture should be
          *          created. The default value is `Background` which indicates a
          *          default background color but one can choose any role.
+         *          The texture might be larger than the rendering area when taken
+         *          from the texture pool: the widget uses its top left part.
          * @param role - the color role to assign to the texture upon creating it,
          *               default value being `Background`.
          * @return - the identifier of the texture which has been created.
@@ -777,6 +1126,59 @@ namespace sdl {
 
       private:
 
+        /**
+         * @brief - The path of a widget from the root of its hierarchy (see the method named
+         *          `computeFocusPath`) and the widgets which can be focused with a `Tab` keyed
+         *          by their path: iterating over the members visits them in traversal order.
+         */
+        using FocusPath = std::vector<unsigned>;
+        using FocusMembers = std::map<FocusPath, SdlWidget*>;
+
+        /**
+         * @brief - Describes the focus ring of a hierarchy, held by its root. The `members`
+         *          allow to find the next or previous widget to focus from any widget of the
+         *          hierarchy without traversing it. They are updated as widgets are added or
+         *          removed or change their focus policy; the ring is only rebuilt when it is
+         *          `stale`. The `revision` is incremented on each update so that a rebuild
+         *          performed concurrently can detect that it missed some of them.
+         *          The `pendingMoves` are the focus moves (`true` for a `BackTab`) requested
+         *          while the ring could not be rebuilt: these are performed in order once it
+         *          is. The `locker` protects the ring and is never held while acquiring any
+         *          other lock.
+         */
+        struct FocusRing {
+          FocusMembers members;
+          bool stale;
+          unsigned revision;
+          std::vector<bool> pendingMoves;
+          std::mutex locker;
+        };
+
+        /**
+         * @brief - Convenience class which locks the `m_contentLocker` of a widget for its
+         *          lifetime unless the calling thread already owns it: this allows to run
+         *          a layout pass from within an event handler of the widget, where the
+         *          locker is already acquired by `handleEvent`.
+         */
+        class ContentGuard {
+          public:
+
+            explicit
+            ContentGuard(const SdlWidget& widget);
+
+            ~ContentGuard();
+
+            ContentGuard(const ContentGuard&) = delete;
+
+            ContentGuard&
+            operator=(const ContentGuard&) = delete;
+
+          private:
+
+            const SdlWidget& m_widget;
+            bool m_locked;
+        };
+
         /**
          * @brief - Asks the engine to perform the needed operations to release the
          *          memory used by the internal `m_content` texture.
@@ -800,6 +1202,43 @@ namespace sdl {
         void
         clearCachedTexture();
 
+        /**
+         * @brief - Releases the input texture: it is returned to the texture pool if any
+         *          so that it can be reused, and destroyed otherwise. The identifier is
+         *          invalidated in the process.
+         * @param uuid - the identifier of the texture to release.
+         */
+        void
+        releaseTexture(utils::Uuid& uuid);
+
+        /**
+         * @brief - Used to draw the input textureless `widget` into the content of `this`
+         *          widget: the `region` is filled with the color of the `widget` and its
+         *          children are then drawn on top of it. Textureless children are handled
+         *          recursively.
+         *          Assumes that the `m_contentLocker` is already acquired.
+         * @param widget - the textureless widget to draw.
+         * @param box - the area of the `widget` expressed in `this` widget's local frame.
+         * @param region - the part of the `widget` to draw, expressed in `this` widget's
+         *                 local frame.
+         * @param dims - the dimensions of `this` widget.
+         */
+        void
+        drawTexturelessWidget(SdlWidget& widget,
+                              const utils::Boxf& box,
+                              const utils::Boxf& region,
+                              const utils::Sizef& dims);
+
+        /**
+         * @brief - Used by textureless widgets to forward the paint event to their parent:
+         *          as their representation lives in the content of the parent it is up to
+         *          it to repaint the corresponding regions.
+         *          Only events coming from this widget or one of its children are forwarded.
+         * @param e - the paint event to forward.
+         */
+        void
+        forwardRepaint(const engine::PaintEvent& e);
+
         /**
          * @brief - Used to perform the rendering of the input `widget` element while
          *          providing a safety net in case the drawing fails and raises an
@@ -844,12 +1283,109 @@ namespace sdl {
         shareData(SdlWidget* widget);
 
         /**
-         * @brief - Performs a rebuild of the z ordering of the children widgets. This
-         *          method will sort the `m_children` array and then proceed to update
-         *          the `m_names` with the corresponding indices.
+         * @brief - Assigns the input engine and texture pool to this widget and all its
+         *          children. The content of the widget is released in the process.
+         * @param engine - the engine to assign to this widget.
+         * @param pool - the texture pool to use to create textures with the engine.
+         */
+        void
+        assignEngine(engine::EngineShPtr engine,
+                     TexturePoolShPtr pool) noexcept;
+
+        /**
+         * @brief - Used to indicate that this widget has some pending graphic operations
+         *          which should be processed during the next call to `draw`. The flag is
+         *          propagated to the ancestors of this widget so that the `draw` method
+         *          can reach this widget while skipping subtrees which are up-to-date.
+         *          The propagation stops as soon as an ancestor is found to be already
+         *          marked as dirty.
+         */
+        void
+        markSubtreeDirty() noexcept;
+
+        /**
+         * @brief - Retrieves the outermost widget among this widget and its ancestors for
+         *          which updates are suspended.
+         * @return - the widget suspending the updates of this widget or `null` if the
+         *           updates of this widget are not suspended.
+         */
+        SdlWidget*
+        getUpdatesSuspender() const noexcept;
+
+        /**
+         * @brief - Registers a deferred update for this widget if its updates are suspended.
+         * @param geometry - `true` if the update concerns the geometry and `false` if it is
+         *                   a repaint.
+         * @return - `true` if the update was deferred and should not be performed now.
+         */
+        bool
+        deferUpdate(bool geometry) noexcept;
+
+        /**
+         * @brief - Performs the updates which were deferred while the updates of this widget
+         *          were suspended: the geometry of the whole hierarchy is laid out in a single
+         *          pass and the widgets which requested a repaint register it directly. A
+         *          single repaint event is posted for this widget.
          */
         void
-        rebuildZOrdering();
+        flushDeferredUpdates();
+
+        /**
+         * @brief - Used to register the deferred updates of this widget and of its children
+         *          recursively. The geometry of widgets which were not reached by the layout
+         *          pass is invalidated through the usual events.
+         * @param root - the widget which suspended the updates: its own repaint is handled
+         *               separately.
+         */
+        void
+        flushDeferredUpdatesOf(const SdlWidget* root);
+
+        /**
+         * @brief - Inserts the input widget in the children of this widget with its current
+         *          z order. Assumes that the `m_childrenLocker` is already acquired.
+         * @param widget - the widget to insert.
+         */
+        void
+        insertChild(SdlWidget* widget);
+
+        /**
+         * @brief - Used to determine whether the input object is one of the children
+         *          of this widget. This is typically used to check the emitter of an
+         *          event: the object is identified through its address so the check
+         *          does not require to hash any string nor to query its type.
+         *          Assumes that the `m_childrenLocker` is already acquired.
+         * @param object - the object to search in the children.
+         * @return - `true` if the object is a child of this widget.
+         */
+        bool
+        isChild(const engine::EngineObject* object) const noexcept;
+
+        /**
+         * @brief - Invalidates the cached global offset of this widget and of all its
+         *          descendants. The traversal stops at widgets for which the offset is
+         *          already invalid: a widget never holds a valid offset while its parent
+         *          does not, so their descendants are already invalid as well.
+         */
+        void
+        invalidateGlobalOffset();
+
+        /**
+         * @brief - Used to refresh the entries of the spatial index for the children queued
+         *          through `itemHitAreaChanged`. The priority of each child is defined by its
+         *          z order and its insertion order so that the top most children are visited
+         *          first. Hidden children are removed from the index.
+         *          Assumes that the `m_childrenLocker` is already acquired.
+         */
+        void
+        refreshHitIndex() const;
+
+        /**
+         * @brief - Removes the input child from the spatial index and from the queue of the
+         *          children to refresh. Assumes that the `m_childrenLocker` is already acquired.
+         * @param child - the child to remove.
+         */
+        void
+        removeFromHitIndex(const SdlWidget* child);
 
         /**
          * @brief - Helper method allowing to handle the research and creation of the event
@@ -861,30 +1397,162 @@ namespace sdl {
         bool
         focusNextChild(bool reverse);
 
+        /**
+         * @brief - Used to move the keyboard focus from this widget to the next (or previous)
+         *          widget of the focus ring of the hierarchy containing it. The focus ring is
+         *          cached by the root of the hierarchy and lists all the widgets which can be
+         *          focused with a `Tab` in the order of a depth first traversal, where the
+         *          children of each widget are visited in tab order.
+         *          The focus is directly assigned to the target widget through a single event.
+         *          Note that this widget does not need to be part of the ring.
+         *          The ring is built during the first `draw` of the root and then maintained
+         *          as widgets are added, removed or change their focus policy so the move is
+         *          usually performed right away. Only when the ring is stale (i.e. a `Tab` is
+         *          received before the first `draw` or after a failed update) and cannot be
+         *          rebuilt while processing the event, the move is registered by the root and
+         *          performed from the widget holding the keyboard focus during its next `draw`
+         *          (see `updateFocusRing`): the focus is then moved one frame late but always
+         *          follows the order of the ring.
+         * @param reverse - a boolean indicating whether the event is a `Tab` or a `BackTab`.
+         * @return - `true` if a focus event was sent to another widget.
+         */
+        bool
+        focusNextInRing(bool reverse);
+
+        /**
+         * @brief - Used by the root of a hierarchy to build its focus ring on its first call
+         *          and to perform the focus moves which could not be handled when the related
+         *          `Tab`s were received. This is called at the beginning of each `draw` of the
+         *          root, where no content is locked yet: the children of the widgets can thus
+         *          be locked safely. Nothing is done unless the ring is stale or some moves
+         *          are pending.
+         */
+        void
+        updateFocusRing();
+
+        /**
+         * @brief - Used by the root of a hierarchy to retrieve its focus ring, allocating it
+         *          on the first call. A newly allocated ring is stale.
+         * @return - the focus ring of the hierarchy.
+         */
+        FocusRing&
+        getFocusRing();
+
+        /**
+         * @brief - Used by the root of a hierarchy to rebuild its focus ring if it is stale.
+         *          The `m_childrenLocker` of the widgets are acquired while no other lock is
+         *          held on the ring: the ring is only replaced if it was not modified in the
+         *          meantime.
+         *          The ring is usually rebuilt while processing an event, where the content
+         *          of a widget is locked: as the children of its ancestors are usually locked
+         *          before the content of their descendants, we should only attempt to lock
+         *          them and give up on the rebuild if this is not possible.
+         * @param ring - the focus ring of this widget.
+         * @param wait - `true` if the children of the widgets can be locked safely, `false`
+         *               if we should only attempt to lock them.
+         * @return - `true` if the ring is up to date.
+         */
+        bool
+        rebuildFocusRing(FocusRing& ring,
+                         bool wait);
+
+        /**
+         * @brief - Registers the input widget and all its descendants which can be focused
+         *          with a `Tab` in the `members` of a focus ring.
+         * @param widget - the widget to register.
+         * @param path - the path of the widget from the root of its hierarchy. It is used to
+         *               build the path of the descendants and restored before returning.
+         * @param members - the members to complete.
+         * @param wait - `true` if the children of the widgets can be locked safely.
+         * @return - `false` if the children of one of the widgets could not be locked.
+         */
+        static
+        bool
+        collectFocusMembers(SdlWidget* widget,
+                            FocusPath& path,
+                            FocusMembers& members,
+                            bool wait);
+
+        /**
+         * @brief - Computes the path of this widget from the root of its hierarchy: this is
+         *          the list of the insertion orders of its ancestors (excluding the root) and
+         *          of this widget. Ordering the paths lexicographically gives the order of a
+         *          depth first traversal where the children are visited in tab order.
+         * @param path - output argument receiving the path of this widget.
+         * @return - the root of the hierarchy of this widget.
+         */
+        const SdlWidget*
+        computeFocusPath(FocusPath& path) const;
+
+        /**
+         * @brief - Adds this widget and its descendants to the focus ring of the hierarchy it
+         *          was just inserted into, if the ring is already built. Should be called once
+         *          the widget is registered as a child of its parent.
+         */
+        void
+        registerInFocusRing();
+
+        /**
+         * @brief - Removes this widget and its descendants from the focus ring of the hierarchy
+         *          it belongs to, if the ring is already built. Should be called before this
+         *          widget is detached from its parent.
+         */
+        void
+        unregisterFromFocusRing() noexcept;
+
+        /**
+         * @brief - Used by the root of a hierarchy to perform all the pending focus moves in
+         *          order, starting from the input widget. A single focus event is posted for
+         *          the widget reached by the last move. Nothing is done if the focus ring is
+         *          stale.
+         * @param ring - the focus ring of this widget.
+         * @param from - the widget from which the focus should be moved.
+         * @return - `true` if a focus event was sent to another widget.
+         */
+        bool
+        performFocusMoves(FocusRing& ring,
+                          const SdlWidget* from);
+
       protected:
 
         friend class Layout;
 
+        using Timestamp = std::chrono::time_point<std::chrono::steady_clock>;
+
         /**
          * @brief - Used to describe a children widget and its associated z order.
-         *          The wrapper includes the widget itself and the z order applied
-         *          to the widget.
+         *          The wrapper includes the widget itself, the z order applied to
+         *          the widget and the order in which it was inserted in its parent
+         *          which allows to order children with the same z order. This order
+         *          also defines the position of the child in the tab ordering.
+         *          The record also holds the interned name of the child and the
+         *          timestamp at which an area containing the child has last been
+         *          processed by this widget: this is not part of the ordering and
+         *          can thus be updated in place.
          */
         struct ChildWrapper {
           SdlWidget* widget;
           int zOrder;
+          unsigned order;
+          NamesTable::Handle name;
+          mutable Timestamp repaint;
 
           /**
            * @brief - Builds a child wrapper with the specified widget and z order.
            * @param wid - the widget associated to this wrapper.
            * @param zOrder - the z order for this widget.
+           * @param order - the insertion order of this widget.
+           * @param name - the interned name of the widget.
            */
           ChildWrapper(SdlWidget* wid,
-                       int zOrder = 0);
+                       int zOrder = 0,
+                       unsigned order = 0u,
+                       NamesTable::Handle name = 0u);
 
           /**
            * @brief - Performs the comparison of `this` with the `rhs` value. The
-           *          comparison is performed on the `zOrder` of each element.
+           *          comparison is performed on the `zOrder` of each element and
+           *          then on their insertion order.
            * @param rhs - the element to compare with `this`.
            * @return - true if `this` is less than `rhs`, false otherwise.
            */
@@ -892,15 +1560,29 @@ namespace sdl {
           operator<(const ChildWrapper& rhs) const noexcept;
         };
 
-        using Timestamp = std::chrono::time_point<std::chrono::steady_clock>;
+        using WidgetsMap = std::set<ChildWrapper>;
+        using ChildrenMap = std::unordered_map<NamesTable::Handle, WidgetsMap::iterator>;
+        using EmittersMap = std::unordered_map<const engine::EngineObject*, WidgetsMap::iterator>;
+        using TabOrdering = std::map<unsigned, WidgetsMap::iterator>;
 
-        using ChildrenMap = std::unordered_map<std::string, int>;
-        using WidgetsMap = std::vector<ChildWrapper>;
-        using RepaintMap = std::unordered_map<std::string, Timestamp>;
-        using TabOrdering = std::vector<std::string>;
+        /**
+         * @brief - Moves the input child to its new position in the children of this
+         *          widget if its z order changed. Assumes that the `m_childrenLocker`
+         *          is already acquired.
+         * @param child - the child to update.
+         * @return - `true` if the z order of the child changed.
+         */
+        bool
+        updateChildZOrder(ChildrenMap::iterator child);
 
       private:
 
+        /**
+         * @brief - The identifier of the name of this widget in the names table. It is used
+         *          by the parent of this widget to register it as a child.
+         */
+        NamesTable::Handle m_nameId;
+
         /**
          * @brief - Contains all the children for this widget. Each widget is registered by its
          *          name and we prevent several items with the same name to be registered. Also
@@ -908,19 +1590,20 @@ namespace sdl {
          *          in which they have been added to this item, but it can be specified by using
          *          the dedicated handler.
          *          In order to allow both for easy access to widgets based on their name and
-         *          efficient drawing based on the z order, we use two distinct internal arrays.
+         *          efficient drawing based on the z order, we use two distinct containers: the
+         *          children are kept sorted by ascending z order and the names refer to their
+         *          position in this container, which stays valid until the child is removed.
+         *          This allows to insert, remove or move a child in logarithmic time.
+         *          Names are registered through their identifier in the names table so that
+         *          no string is stored or hashed for the children.
+         *          The children are also registered by address in the `m_emitters` so that
+         *          the emitter of an event can be identified without querying its type.
+         *          The `m_childrenOrder` is used to generate the insertion order of children.
          */
         ChildrenMap m_names;
+        EmittersMap m_emitters;
         WidgetsMap m_children;
-
-        /**
-         * @brief - Describes the timestamps at which an area containing the children area has
-         *          been processed by this widget. When used in conjunction with the repaint
-         *          time of any child it allows to precisely determine which children need to
-         *          be repainted. We can thus easily trash or keep repaint events coming from
-         *          some particular child.
-         */
-        RepaintMap m_childrenRepaints;
+        unsigned m_childrenOrder;
 
         /**
          * @brief - Hold the ordering of the children widgets regarding the tab cycling. Each
@@ -929,9 +1612,9 @@ namespace sdl {
          *          can be handled before proposing it to the child though so as not to waste
          *          cycles.
          *          This cycle cannot be modified yet and is not affected by `z` order modifs.
-         *          Note that when a child is removed from the widget its corresponding tab
-         *          entry is removed as well and the following children are moved to occupy
-         *          the free spot.
+         *          Entries are indexed by the insertion order of the children so that the
+         *          entry of a child can be removed directly when it is removed. They refer
+         *          to the position of the child in the `m_children`.
          */
         TabOrdering m_tabOrder;
 
@@ -947,6 +1630,45 @@ namespace sdl {
          */
         mutable std::mutex m_childrenLocker;
 
+        /**
+         * @brief - Spatial index of the children of this widget based on their hit area in the
+         *          local frame of this widget. It allows to quickly determine which children
+         *          might span a position without traversing all of them. Each child is visited
+         *          by descending `z` order and insertion order. Protected by `m_childrenLocker`.
+         */
+        mutable SpatialIndex<const SdlWidget*, std::pair<int, unsigned>> m_hitIndex;
+
+        /**
+         * @brief - The children whose entry in the spatial index should be refreshed before
+         *          the next query. The queue is protected by its own lock which is never held
+         *          while acquiring another one: this allows children to notify their parent
+         *          from any context. The refresh buffer is only used to process the queue and
+         *          is protected by the `m_childrenLocker`.
+         */
+        mutable std::vector<const LayoutItem*> m_hitUpdates;
+        mutable std::vector<const LayoutItem*> m_hitRefresh;
+        mutable std::mutex m_hitUpdatesLocker;
+
+        /**
+         * @brief - Cached values derived from the position of this widget in the hierarchy.
+         *          The `z` order key stores the geometry epoch at which it was computed while
+         *          the global offset is explicitly invalidated when this widget or any of its
+         *          ancestors is moved or reparented. Protected by the `m_hierarchyLocker`.
+         */
+        mutable ZOrderKey m_zOrderKey;
+        mutable unsigned m_zOrderKeyEpoch;
+        mutable utils::Vector2f m_globalOffset;
+        mutable bool m_globalOffsetValid;
+
+        /**
+         * @brief - Used to protect the values cached from the position of this widget in the
+         *          hierarchy. This is a separate mutex so that these values can be accessed
+         *          while the content or the children of this widget are locked. The lock of
+         *          a widget can be held while acquiring the one of its parent but not the
+         *          other way around.
+         */
+        mutable std::mutex m_hierarchyLocker;
+
         /**
          * @brief - The layout which handles positionning of children widget in the space for
          *          this widget. Basically the parent of this widget or the layout it is linked
@@ -975,6 +1697,13 @@ namespace sdl {
          */
         engine::EngineShPtr m_engine;
 
+        /**
+         * @brief - The pool used to recycle the textures created with the engine. This pool
+         *          is shared among all the widgets using the same engine so that textures
+         *          released by a widget can be reused by another one.
+         */
+        TexturePoolShPtr m_texturePool;
+
         /**
          * @brief - Represents the parent widget of this object. This parent allows to benefit
          *          from the rendering process and to share the data such as engine or events
@@ -982,6 +1711,13 @@ namespace sdl {
          */
         SdlWidget* m_parent;
 
+        /**
+         * @brief - The insertion order of this widget in its parent, which is also its key in
+         *          the tab ordering of the parent. Used to locate the widget in the focus ring
+         *          of its hierarchy without locking its ancestors.
+         */
+        unsigned m_childOrder;
+
         /**
          * @brief - Used to determine whether the rendering information held by this widget is up
          *          to date. This is particularly useful to delay repaint computations to a later
@@ -992,6 +1728,78 @@ namespace sdl {
          */
         bool m_contentDirty;
 
+        /**
+         * @brief - Indicates whether this widget should be drawn without textures along with
+         *          the color role to use to fill it in this case. The role is also used as a
+         *          default when creating the content of the widget.
+         *          Both values are read by the parent from the rendering thread and are thus
+         *          stored as atomic values.
+         */
+        std::atomic_bool m_textureless;
+        std::atomic<engine::Palette::ColorRole> m_fillRole;
+
+        /**
+         * @brief - Indicates whether this widget is opaque: this allows the parent to skip
+         *          the parts of the siblings which are covered by this widget.
+         */
+        std::atomic_bool m_opaque;
+
+        /**
+         * @brief - Indicates whether a synchronous layout pass is running for this widget: in
+         *          this case the layout is updated right away instead of through an event.
+         */
+        bool m_synchronousLayout;
+
+        /**
+         * @brief - Number of pending calls to `suspendUpdates` on this widget. The deferred
+         *          flags indicate whether this widget registered a repaint or a geometry
+         *          update while suspended and the pending flags indicate the same for the
+         *          whole hierarchy when this widget is the one suspending the updates.
+         */
+        std::atomic_uint m_updatesSuspended;
+        std::atomic_bool m_deferredRepaint;
+        std::atomic_bool m_deferredGeometry;
+        std::atomic_bool m_pendingRepaint;
+        std::atomic_bool m_pendingGeometry;
+
+        /**
+         * @brief - Number of widgets for which updates are suspended, among all hierarchies.
+         *          As long as it is zero there's no need to traverse the ancestors of a widget
+         *          to find out whether its updates are suspended.
+         */
+        static std::atomic_uint m_suspendedWidgets;
+
+        /**
+         * @brief - Indicates that either this widget or one of its descendants has pending
+         *          graphic operations which should be processed in the next `draw` call. It
+         *          is set whenever a repaint operation is registered and propagated to the
+         *          ancestors so that the `draw` method only traverses branches which have
+         *          actually something to do.
+         *          As this flag is set from the events thread and cleared from the rendering
+         *          thread it is stored as an atomic value.
+         */
+        std::atomic_bool m_subtreeDirty;
+
+        /**
+         * @brief - Counts the number of widgets visited during the last `draw` call on this
+         *          widget (including this widget). Only accessed from the main thread.
+         */
+        unsigned m_drawVisits;
+
+        /**
+         * @brief - Counters describing the number of update regions received through paint
+         *          events and the number of rectangles which were actually repainted after
+         *          merging them. Only updated from the main thread.
+         */
+        unsigned m_repaintRegions;
+        unsigned m_repaintRectangles;
+
+        /**
+         * @brief - Counts the number of children which were not drawn during a repaint as they
+         *          were covered by opaque siblings. Only updated from the main thread.
+         */
+        unsigned m_occludedChildren;
+
         /**
          * @brief - True if the mouse cursor is currently hovering over this widget. False otherwise. This
          *          attribute is updated upon receiving `EnterEvent` and `LeaveEvent`.
@@ -1014,6 +1822,22 @@ namespace sdl {
          */
         FocusState  m_internalFocusState;
 
+        /**
+         * @brief - The child of this widget which is on the path to the widget holding the
+         *          keyboard focus: it is either the focused widget itself or one of its
+         *          ancestors. Null if no descendant of this widget has the keyboard focus.
+         *          This allows to determine which child should receive the key events and
+         *          to cycle through the children without looking for the focused one.
+         */
+        std::atomic<SdlWidget*> m_keyboardChild;
+
+        /**
+         * @brief - The focus ring of the hierarchy when this widget is its root, allocated by
+         *          `getFocusRing` and released when the widget is destroyed or inserted in
+         *          another hierarchy. Other widgets never allocate it.
+         */
+        std::atomic<FocusRing*> m_focusRing;
+
         /**
          * @brief - Contains an identifier representing the current visual content associated to
          *          this widget. Such identifier is related to an underlying engine and allows to
@@ -1050,6 +1874,13 @@ namespace sdl {
          */
         mutable std::mutex m_contentLocker;
 
+        /**
+         * @brief - The thread currently owning the `m_contentLocker` through a `ContentGuard`
+         *          or a default identifier if no thread owns it this way. This is used to
+         *          detect re-entrant calls which would otherwise lock the mutex twice.
+         */
+        mutable std::atomic<std::thread::id> m_contentOwner;
+
         /**
          * @brief - Containes the identifier of the texture currently cached for display purpose.
          *          While the container or one of its children is not modified it will be used
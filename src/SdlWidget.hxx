@@ -8,15 +8,20 @@ namespace sdl {
 
     inline
     SdlWidget::ChildWrapper::ChildWrapper(SdlWidget* wid,
-                                          int zOrder):
+                                          int zOrder,
+                                          unsigned order,
+                                          NamesTable::Handle name):
       widget(wid),
-      zOrder(zOrder)
+      zOrder(zOrder),
+      order(order),
+      name(name),
+      repaint()
     {}
 
     inline
     bool
     SdlWidget::ChildWrapper::operator<(const ChildWrapper& rhs) const noexcept {
-      return zOrder < rhs.zOrder;
+      return zOrder < rhs.zOrder || (zOrder == rhs.zOrder && order < rhs.order);
     }
 
     inline
@@ -40,7 +45,7 @@ namespace sdl {
       utils::Boxf thisBox = LayoutItem::getDrawingArea();
 
       // Map the center to global coordinate.
-      utils::Vector2f globalOffset = mapToGlobal(utils::Vector2f());
+      utils::Vector2f globalOffset = getGlobalOffset();
 
       // Compute final position from both boxes.
       return utils::Boxf(globalOffset, thisBox.w(), thisBox.h());
@@ -66,6 +71,34 @@ namespace sdl {
       return orders;
     }
 
+    inline
+    ZOrderKey
+    SdlWidget::getZOrderKey() const noexcept {
+      // Use the cached value if it is still valid.
+      const unsigned epoch = getGeometryEpoch();
+      {
+        const std::lock_guard guard(m_hierarchyLocker);
+        if (m_zOrderKeyEpoch == epoch) {
+          return m_zOrderKey;
+        }
+      }
+
+      // Build the key from the one of the parent if any. Note that we
+      // don't hold the lock while doing so to not nest the locks of the
+      // ancestors.
+      const ZOrderKey key = (
+        hasParent() ?
+        ZOrderKey(m_parent->getZOrderKey(), getZOrder()) :
+        ZOrderKey(getZOrder())
+      );
+
+      const std::lock_guard guard(m_hierarchyLocker);
+      m_zOrderKey = key;
+      m_zOrderKeyEpoch = epoch;
+
+      return key;
+    }
+
     inline
     void
     SdlWidget::setLayout(std::shared_ptr<Layout> layout) noexcept {
@@ -75,6 +108,7 @@ namespace sdl {
       // Share the events queue if needed.
       if (hasLayout()) {
         registerToSameQueue(m_layout.get());
+        m_layout->m_container = this;
       }
 
       // Install this widget as filter for the event of the layout.
@@ -99,24 +133,39 @@ namespace sdl {
     inline
     void
     SdlWidget::setEngine(engine::EngineShPtr engine) noexcept {
-      // Release the content of this widget if any.
-      clearTexture();
+      // Create a new texture pool for this engine and share it with the
+      // children.
+      assignEngine(engine, engine == nullptr ? nullptr : std::make_shared<TexturePool>(engine));
+    }
 
-      // Assign the engine to this widget.
-      m_engine = engine;
+    inline
+    TexturePoolShPtr
+    SdlWidget::getTexturePool() const noexcept {
+      return m_texturePool;
+    }
 
-      // Also: assign the engine to children widgets if any.
-      {
-        const std::lock_guard guard(m_childrenLocker);
-        for (WidgetsMap::const_iterator child = m_children.cbegin() ;
-            child != m_children.cend() ;
-            ++child)
-        {
-          child->widget->setEngine(engine);
-        }
-      }
+    inline
+    unsigned
+    SdlWidget::getDrawVisitsCount() const noexcept {
+      return m_drawVisits;
+    }
 
-      makeContentDirty();
+    inline
+    unsigned
+    SdlWidget::getRepaintRegionsCount() const noexcept {
+      return m_repaintRegions;
+    }
+
+    inline
+    unsigned
+    SdlWidget::getRepaintRectanglesCount() const noexcept {
+      return m_repaintRectangles;
+    }
+
+    inline
+    unsigned
+    SdlWidget::getOccludedChildrenCount() const noexcept {
+      return m_occludedChildren;
     }
 
     inline
@@ -191,15 +240,79 @@ namespace sdl {
         return;
       }
 
+      // This widget leaves the focus ring of its current hierarchy if any:
+      // it either becomes a root or joins the ring of its new hierarchy.
+      if (hasParent()) {
+        unregisterFromFocusRing();
+      }
+      if (parent != nullptr) {
+        delete m_focusRing.exchange(nullptr);
+      }
+
       // Assign the parent.
       m_parent = parent;
 
+      // The position of this widget in the global coordinate frame changed.
+      invalidateGlobalOffset();
+      invalidateGeometryEpoch();
+
       // Share data with the parent.
       if (hasParent()) {
         m_parent->addWidget(this);
       }
     }
 
+    inline
+    bool
+    SdlWidget::isOpaque() const noexcept {
+      return m_opaque && isVisible();
+    }
+
+    inline
+    void
+    SdlWidget::setOpaque(bool opaque) {
+      if (m_opaque == opaque) {
+        return;
+      }
+
+      m_opaque = opaque;
+
+      // The siblings covered by this widget might need to be repainted.
+      requestRepaint();
+    }
+
+    inline
+    bool
+    SdlWidget::isTextureless() const noexcept {
+      return m_textureless && hasParent();
+    }
+
+    inline
+    void
+    SdlWidget::setTextureless(bool textureless) {
+      {
+        const std::lock_guard guard(m_contentLocker);
+
+        if (m_textureless == textureless) {
+          return;
+        }
+
+        m_textureless = textureless;
+
+        // Release the textures used by this widget: the color role of the
+        // content is kept to fill the widget in its parent.
+        if (m_textureless) {
+          m_fillRole = clearTexture();
+
+          const std::lock_guard cGuard(m_cacheLocker);
+          clearCachedTexture();
+          m_repaintOperation.reset();
+        }
+      }
+
+      makeContentDirty();
+    }
+
     inline
     void
     SdlWidget::makeContentDirty() {
@@ -215,6 +328,11 @@ namespace sdl {
     SdlWidget::requestRepaint(const bool allArea,
                               const utils::Boxf& area) noexcept
     {
+      // The repaint is performed once the updates are resumed.
+      if (deferUpdate(false)) {
+        return;
+      }
+
       // Determine the area which should be updated: this will
       // indicate the type of event to create.
       utils::Boxf toRepaint = area;
@@ -234,7 +352,7 @@ namespace sdl {
       utils::Boxf global = mapToGlobal(toRepaint, false);
 
       // Create the paint event.
-      engine::PaintEventShPtr e = std::make_shared<engine::PaintEvent>(global);
+      engine::PaintEventShPtr e = EventsPool::create<engine::PaintEvent>(global);
 
       // Post it to trigger a content update.
       postEvent(e);
@@ -243,6 +361,11 @@ namespace sdl {
     inline
     void
     SdlWidget::makeGeometryDirty() {
+      // The geometry is recomputed once the updates are resumed.
+      if (deferUpdate(true)) {
+        return;
+      }
+
       // Mark the geometry as dirty.
       LayoutItem::makeGeometryDirty();
 
@@ -263,15 +386,58 @@ namespace sdl {
       LayoutItem::updatePrivate(window);
 
       // Update the layout if any.
-      if (hasLayout()) {
-        postEvent(std::make_shared<engine::ResizeEvent>(window, old, m_layout.get()));
+      if (!hasLayout()) {
+        return;
+      }
+
+      if (m_synchronousLayout) {
+        m_layout->layoutSynchronously(window);
+        return;
+      }
+
+      postEvent(EventsPool::create<engine::ResizeEvent>(window, old, m_layout.get()));
+    }
+
+    inline
+    void
+    SdlWidget::suspendUpdates() noexcept {
+      if (m_updatesSuspended++ == 0u) {
+        ++m_suspendedWidgets;
+      }
+    }
+
+    inline
+    bool
+    SdlWidget::areUpdatesSuspended() const noexcept {
+      return getUpdatesSuspender() != nullptr;
+    }
+
+    inline
+    SdlWidget::UpdatesBlocker::UpdatesBlocker(SdlWidget& widget) noexcept:
+      m_widget(widget)
+    {
+      m_widget.suspendUpdates();
+    }
+
+    inline
+    SdlWidget::UpdatesBlocker::~UpdatesBlocker() noexcept {
+      // Performing the deferred updates might fail: as we can't throw from
+      // a destructor the error is only reported.
+      try {
+        m_widget.resumeUpdates();
+      }
+      catch (const std::exception& e) {
+        m_widget.warn(std::string("Could not resume updates (err: ") + e.what() + ")");
+      }
+      catch (...) {
+        m_widget.warn(std::string("Could not resume updates"));
       }
     }
 
     inline
     bool
     SdlWidget::handleEvent(engine::EventShPtr e) {
-      const std::lock_guard guard(m_contentLocker);
+      const ContentGuard guard(*this);
       return LayoutItem::handleEvent(e);
     }
 
@@ -281,8 +447,9 @@ namespace sdl {
       // Use the base handler to perform needed internal updates.
       const bool toReturn = LayoutItem::showEvent(e);
 
-      // Trigger a repaint event if the widget is set to visible.
-      if (isVisible()) {
+      // Trigger a repaint event if the widget is set to visible: when
+      // called by a layout pass the repaint is registered by the pass.
+      if (isVisible() && !isApplyingGeometry()) {
         makeContentDirty();
       }
 
@@ -310,48 +477,40 @@ namespace sdl {
       const std::lock_guard guard(m_childrenLocker);
 
       // Check whether we can find this widget in the internal table.
-      ChildrenMap::const_iterator child = m_names.find(widget->getName());
-      if (child == m_names.cend()) {
+      ChildrenMap::const_iterator child = m_names.find(widget->m_nameId);
+      if (child == m_names.cend() || child->second->widget != widget) {
         error(
           std::string("Cannot remove widget \"") + widget->getName() + "\" from parent",
           std::string("No such item")
         );
       }
 
-      if (child->second < 0 || child->second >= getChildrenCount()) {
-        error(
-          std::string("Cannot remove widget \"") + widget->getName() + "\" from parent",
-          std::string("Item has invalid internal index ") + std::to_string(child->second) +
-          " while only " + std::to_string(getChildrenCount()) + " are available"
-        );
-      }
-
-      // Remove the widget from the children list.
-      m_children.erase(m_children.begin() + child->second);
+      // The widget and its descendants cannot be reached with `Tab`s anymore.
+      widget->unregisterFromFocusRing();
 
       // Remove the widget from the tab ordering.
-      TabOrdering::iterator it = m_tabOrder.begin();
-      while (it != m_tabOrder.end() && *it != widget->getName()) {
-        ++it;
-      }
-
-      if (it ==  m_tabOrder.end()) {
+      if (m_tabOrder.erase(child->second->order) == 0u) {
         warn("Could not find widget \"" + widget->getName() + "\" in tab ordering");
       }
-      else {
-        m_tabOrder.erase(it);
-      }
 
-      // Remove the widget from the repaints' timestamps. We might fail to
-      // find this widget if it has not been repainted at all. Weird but
-      // not impossible.
-      m_childrenRepaints.erase(widget->getName());
+      // Remove the widget from the children list: this also discards its
+      // repaint timestamp.
+      removeFromHitIndex(widget);
+      m_emitters.erase(widget);
+
+      // The widget cannot lead to the keyboard focus anymore.
+      SdlWidget* focused = widget;
+      m_keyboardChild.compare_exchange_strong(focused, nullptr);
+      m_children.erase(child->second);
+      m_names.erase(child);
 
       // Delete the widget to release the memory.
       delete widget;
 
-      // Rebuild the internal list of associations.
-      rebuildZOrdering();
+      // The stacking order of the children changed: caches relying on it
+      // should be refreshed.
+      invalidateGeometryEpoch();
+      hitAreaChanged();
     }
 
     inline
@@ -386,13 +545,30 @@ namespace sdl {
     inline
     bool
     SdlWidget::hasChild(const std::string& name) const noexcept {
+      // A name which was never interned cannot belong to any child.
+      const NamesTable::Handle id = NamesTable::find(name);
+      if (id == 0u) {
+        return false;
+      }
+
       // Try to retrieve an iterator on the child.
-      ChildrenMap::const_iterator child = m_names.find(name);
+      ChildrenMap::const_iterator child = m_names.find(id);
 
       // If we managed to find a child with a similar name we're good.
       return child != m_names.cend();
     }
 
+    inline
+    bool
+    SdlWidget::hasChild(const SdlWidget* widget) const noexcept {
+      if (widget == nullptr) {
+        return false;
+      }
+
+      ChildrenMap::const_iterator child = m_names.find(widget->m_nameId);
+      return child != m_names.cend() && child->second->widget == widget;
+    }
+
     template <typename WidgetType>
     inline
     WidgetType*
@@ -416,20 +592,12 @@ namespace sdl {
     SdlWidget::getChildOrNull(const std::string& name) const {
       const std::lock_guard guard(m_childrenLocker);
 
-      ChildrenMap::const_iterator child = m_names.find(name);
+      ChildrenMap::const_iterator child = m_names.find(NamesTable::find(name));
       if (child == m_names.cend()) {
         return nullptr;
       }
 
-      if (child->second < 0 || child->second >= getChildrenCount()) {
-        error(
-          std::string("Cannot retrieve widget \"") + name + "\" in parent",
-          std::string("Item has invalid internal index ") + std::to_string(child->second) +
-          " while only " + std::to_string(getChildrenCount()) + " are available"
-        );
-      }
-
-      return dynamic_cast<WidgetType*>(m_children[child->second].widget);
+      return dynamic_cast<WidgetType*>(child->second->widget);
     }
 
     template <typename LayoutType>
@@ -472,17 +640,13 @@ namespace sdl {
       // account for the `local` coordinate.
       utils::Vector2f global = local;
 
-      utils::Boxf area = LayoutItem::getRenderingArea();
-
-      // Now we need to account for the position of this widget.
-      global.x() += area.x();
-      global.y() += area.y();
+      // Now we need to account for the position of this widget and
+      // the transform applied to the parent if any: this is exactly
+      // described by the global offset.
+      const utils::Vector2f offset = getGlobalOffset();
 
-      // Now we need to account for the transform applied to the parent
-      // if any.
-      if (hasParent()) {
-        global = m_parent->mapToGlobal(global);
-      }
+      global.x() += offset.x();
+      global.y() += offset.y();
 
       // This is the global representation of the input local position.
       return global;
@@ -495,27 +659,51 @@ namespace sdl {
       // account for the `global` coordinate.
       utils::Vector2f local = global;
 
-      // Account for the transformation applied to the parent
-      // if any.
-      if (hasParent()) {
-        local = m_parent->mapFromGlobal(local);
-      }
+      // Now we need to account for the position of this widget and the
+      // transformation applied to the parent if any. As most of the
+      // conversion process is already handled in engine, we don't have
+      // to handle anything here. The position is already given according
+      // to the same coordinate frame used by widgets: we only need to
+      // account for the global offset of the widget.
+      const utils::Vector2f offset = getGlobalOffset();
 
-      // Now we need to account for the position of this widget.
-      // As most of the conversion process is already handled in
-      // engine, we don't have to handle anything here. The position
-      // is already given according to the same coordinate frame used
-      // by widgets: we only need to account for the position of the
-      // widget in its parent.
-      utils::Boxf area = LayoutItem::getRenderingArea();
-
-      local.x() -= area.x();
-      local.y() -= area.y();
+      local.x() -= offset.x();
+      local.y() -= offset.y();
 
       // This is the local representation of the input global position.
       return local;
     }
 
+    inline
+    utils::Vector2f
+    SdlWidget::getGlobalOffset() const noexcept {
+      // Use the cached value if it is still valid: it is invalidated when
+      // this widget or any of its ancestors is moved or reparented.
+      const std::lock_guard guard(m_hierarchyLocker);
+      if (m_globalOffsetValid) {
+        return m_globalOffset;
+      }
+
+      // The offset is the position of this widget in its parent composed
+      // with the offset of the parent if any. The lock is held while the
+      // parent is queried: an invalidation of the parent happening in the
+      // meantime waits for the value to be stored before invalidating it.
+      const utils::Boxf area = LayoutItem::getRenderingArea();
+      utils::Vector2f offset(area.x(), area.y());
+
+      if (hasParent()) {
+        const utils::Vector2f parent = m_parent->getGlobalOffset();
+
+        offset.x() += parent.x();
+        offset.y() += parent.y();
+      }
+
+      m_globalOffset = offset;
+      m_globalOffsetValid = true;
+
+      return offset;
+    }
+
     inline
     utils::Boxf
     SdlWidget::mapToGlobal(const utils::Boxf& local,
@@ -672,13 +860,19 @@ namespace sdl {
         // Trigger the process to hide `this` widget.
         toReturn = LayoutItem::hideEvent(e);
 
+        // When called by a layout pass the region to repaint is returned
+        // to the layout which notifies the parent itself.
+        if (isApplyingGeometry()) {
+          return toReturn;
+        }
+
         // Also notify the parent from this hide operation: we need to build the
         // global representation of the current rendering area is of now. We can't
         // really use the `getDrawingArea` method even though it's kind of what we
         // are trying to achieve because the `m_contentLocker` is already locked
         // due to use being in an event handling method. So we will convert the
         // area manually.
-        engine::HideEventShPtr he = std::make_shared<engine::HideEvent>(e.getHiddenRegion());
+        engine::HideEventShPtr he = EventsPool::create<engine::HideEvent>(e.getHiddenRegion());
         engine::EngineObject* o = nullptr;
 
         if (hasParent()) {
@@ -710,7 +904,7 @@ namespace sdl {
 
       // Determine whether the event comes from one of the children
       // of `this` widget.
-      if (e.isSpontaneous() || !hasChild(e.getEmitter()->getName())) {
+      if (e.isSpontaneous() || !isChild(e.getEmitter())) {
         // The hide event should probably not have been sent to
         // `this` widget. Do nothing more.
         return toReturn;
@@ -721,7 +915,7 @@ namespace sdl {
       // child right now because some events might have modify the actual
       // area occupied by the child: in this case we would not repaint a
       // valid area and could be faced with remains of the hidden child.
-      engine::PaintEventShPtr pe = std::make_shared<engine::PaintEvent>(e.getHiddenRegion());
+      engine::PaintEventShPtr pe = EventsPool::create<engine::PaintEvent>(e.getHiddenRegion());
       postEvent(pe, true, true);
 
       // Transmit the return value.
@@ -742,7 +936,7 @@ namespace sdl {
       postEvent(engine::FocusEvent::createFocusInEvent(engine::FocusEvent::Reason::MouseFocus, true));
 
       // Fire a signal indicating that a click on this widget has been detected.
-      verbose("Emitting on click for " + getName());
+      lazyLog<LogLevel::Verbose>([&]() { return "Emitting on click for " + getName(); });
 
       onClick.safeEmit(
         std::string("onClick(") + getName() + ")",
@@ -764,7 +958,7 @@ namespace sdl {
       // checked by verifying that he mouse is still considered
       // outside of this widget).
       if (!isMouseInside()) {
-        postEvent(std::make_shared<engine::EnterEvent>(e.getMousePosition()));
+        postEvent(EventsPool::create<engine::EnterEvent>(e.getMousePosition()));
       }
 
       // Use base handler to determine whether the event was recognized.
@@ -775,9 +969,13 @@ namespace sdl {
     utils::Uuid
     SdlWidget::createContentPrivate(const engine::Palette::ColorRole& role) const {
       // Create the texture using the engine. The dmensions are retrieved from the
-      // internal area.
+      // internal area. We use the texture pool to recycle a texture if possible.
       utils::Boxf area = LayoutItem::getRenderingArea();
-      utils::Uuid uuid = getEngine().createTexture(area.toSize(), role);
+      utils::Uuid uuid = (
+        m_texturePool != nullptr ?
+        m_texturePool->acquire(area.toSize(), role) :
+        getEngine().createTexture(area.toSize(), role)
+      );
 
       // Return the texture.
       return uuid;
@@ -852,11 +1050,7 @@ namespace sdl {
         const std::lock_guard guard(m_childrenLocker);
 
         // Check for duplicated widget
-        if (m_names.find(widget->getName()) != m_names.cend()) {
-          error(std::string("Cannot add duplicated widget \"") + widget->getName() + "\"");
-        }
-
-        if (m_childrenRepaints.find(widget->getName()) != m_childrenRepaints.cend()) {
+        if (m_names.find(widget->m_nameId) != m_names.cend()) {
           error(std::string("Cannot add duplicated widget \"") + widget->getName() + "\"");
         }
       }
@@ -868,25 +1062,20 @@ namespace sdl {
       // filter out events in case the parent is made invisible.
       widget->installEventFilter(this);
 
-      // Populate internal arrays: first insert the item in the `m_children`
-      // array.
+      // Populate internal containers: the children are kept sorted so
+      // there's no need to sort them again.
       {
         const std::lock_guard guard(m_childrenLocker);
 
-        m_children.push_back(
-          ChildWrapper{
-            widget,
-            widget->getZOrder()
-          }
-        );
+        insertChild(widget);
 
-        // Insert into the tab ordering.
-        m_tabOrder.push_back(widget->getName());
-
-        // And now rebuilt the `m_names` array after sorting items in ascending
-        // z order.
-        rebuildZOrdering();
+        // The stacking order of the children changed: caches relying on it
+        // should be refreshed.
+        invalidateGeometryEpoch();
       }
+
+      // The widget can be reached with `Tab`s from now on.
+      widget->registerInFocusRing();
     }
 
     inline
@@ -995,6 +1184,17 @@ namespace sdl {
       // modified. This can only occur if the texture representing the content
       // is valid, obviously.
 
+      // Textureless widgets do not have any content: the role is used by the
+      // parent when filling the widget.
+      if (isTextureless()) {
+        if (m_fillRole != state.getColorRole()) {
+          m_fillRole = state.getColorRole();
+          requestRepaint();
+        }
+
+        return;
+      }
+
       // If the content is not valid, nothing can be done.
       if (!m_content.valid()) {
         warn("Trashing texture role update because content is not valid");
@@ -1027,16 +1227,15 @@ namespace sdl {
     engine::Palette::ColorRole
     SdlWidget::clearTexture() {
       // Assume default color role.
-      engine::Palette::ColorRole role = engine::Palette::ColorRole::Background;
+      engine::Palette::ColorRole role = m_fillRole;
 
       // Destroy the content if any.
       if (m_content.valid()) {
         // Update the color role.
         role = getEngine().getTextureRole(m_content);
 
-        // Destroy the texture.
-        getEngine().destroyTexture(m_content);
-        m_content.invalidate();
+        // Return the texture to the pool.
+        releaseTexture(m_content);
       }
 
       // Return the color role.
@@ -1047,9 +1246,23 @@ namespace sdl {
     void
     SdlWidget::clearCachedTexture() {
       if (m_cachedContent.valid()) {
-        getEngine().destroyTexture(m_cachedContent);
-        m_cachedContent.invalidate();
+        releaseTexture(m_cachedContent);
+      }
+    }
+
+    inline
+    void
+    SdlWidget::releaseTexture(utils::Uuid& uuid) {
+      // Return the texture to the pool if any so that it can be reused,
+      // otherwise destroy it.
+      if (m_texturePool != nullptr) {
+        m_texturePool->release(uuid);
+      }
+      else {
+        getEngine().destroyTexture(uuid);
       }
+
+      uuid.invalidate();
     }
 
     inline
@@ -1065,7 +1278,101 @@ namespace sdl {
 
       // Assign the engine to this widget if none is assigned.
       if (widget->m_engine == nullptr) {
-        widget->setEngine(m_engine);
+        widget->assignEngine(m_engine, m_texturePool);
+      }
+    }
+
+    inline
+    void
+    SdlWidget::assignEngine(engine::EngineShPtr engine,
+                            TexturePoolShPtr pool) noexcept
+    {
+      // Release the content of this widget if any.
+      clearTexture();
+
+      // Assign the engine to this widget.
+      m_engine = engine;
+      m_texturePool = pool;
+
+      // Also: assign the engine to children widgets if any.
+      {
+        const std::lock_guard guard(m_childrenLocker);
+        for (WidgetsMap::const_iterator child = m_children.cbegin() ;
+            child != m_children.cend() ;
+            ++child)
+        {
+          child->widget->assignEngine(engine, pool);
+        }
+      }
+
+      makeContentDirty();
+    }
+
+    inline
+    SdlWidget::ContentGuard::ContentGuard(const SdlWidget& widget):
+      m_widget(widget),
+      m_locked(false)
+    {
+      // The owner can only be equal to the calling thread if it set it
+      // itself, in which case it already holds the locker.
+      if (m_widget.m_contentOwner.load() == std::this_thread::get_id()) {
+        return;
+      }
+
+      m_widget.m_contentLocker.lock();
+      m_widget.m_contentOwner = std::this_thread::get_id();
+      m_locked = true;
+    }
+
+    inline
+    SdlWidget::ContentGuard::~ContentGuard() {
+      if (!m_locked) {
+        return;
+      }
+
+      m_widget.m_contentOwner = std::thread::id();
+      m_widget.m_contentLocker.unlock();
+    }
+
+    inline
+    SdlWidget*
+    SdlWidget::getUpdatesSuspender() const noexcept {
+      // Most of the time no widget suspends its updates: in this case we
+      // don't need to traverse the ancestors.
+      if (m_suspendedWidgets == 0u) {
+        return nullptr;
+      }
+
+      // Walk the whole chain of ancestors: the outermost suspension is the
+      // one which will perform the updates.
+      SdlWidget* suspender = nullptr;
+      const SdlWidget* widget = this;
+
+      while (widget != nullptr) {
+        if (widget->m_updatesSuspended > 0u) {
+          suspender = const_cast<SdlWidget*>(widget);
+        }
+
+        widget = widget->m_parent;
+      }
+
+      return suspender;
+    }
+
+    inline
+    void
+    SdlWidget::markSubtreeDirty() noexcept {
+      // Mark this widget as dirty no matter its current status: we always
+      // want to notify at least the parent in case it would have skipped
+      // this widget during a previous `draw` (typically because it was not
+      // visible at the time).
+      m_subtreeDirty = true;
+
+      // Walk up the chain of ancestors until we find one which is already
+      // marked as dirty: any ancestor above it is already marked as well.
+      SdlWidget* ancestor = m_parent;
+      while (ancestor != nullptr && !ancestor->m_subtreeDirty.exchange(true)) {
+        ancestor = ancestor->m_parent;
       }
     }
 
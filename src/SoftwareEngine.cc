@@ -0,0 +1,238 @@
+
+# include "SoftwareEngine.hh"
+
+namespace sdl {
+  namespace core {
+
+    SoftwareEngine::SoftwareEngine():
+      utils::CoreObject(std::string("software_engine")),
+      engine::Engine(),
+
+      m_textures(),
+      m_window(),
+      m_fonts(),
+      m_scratch(),
+
+      m_locker()
+    {
+      setService(std::string("engine"));
+    }
+
+    utils::Uuid
+    SoftwareEngine::createWindow(const utils::Sizei& size,
+                                 const std::string& /*title*/)
+    {
+      const std::lock_guard guard(m_locker);
+
+      m_window = allocateTexture(std::max(size.w(), 0), std::max(size.h(), 0), engine::Palette::ColorRole::Background);
+      return m_window;
+    }
+
+    void
+    SoftwareEngine::setWindowIcon(const utils::Uuid& /*uuid*/,
+                                  const std::string& /*icon*/)
+    {}
+
+    void
+    SoftwareEngine::clearWindow(const utils::Uuid& uuid) {
+      const std::lock_guard guard(m_locker);
+
+      Texture& window = getTextureOrThrow(uuid);
+      std::fill(window.pixels.begin(), window.pixels.end(), 0u);
+    }
+
+    void
+    SoftwareEngine::renderWindow(const utils::Uuid& uuid) {
+      const std::lock_guard guard(m_locker);
+      getTextureOrThrow(uuid);
+    }
+
+    void
+    SoftwareEngine::destroyWindow(const utils::Uuid& uuid) {
+      const std::lock_guard guard(m_locker);
+
+      if (uuid == m_window) {
+        m_window.invalidate();
+      }
+
+      m_textures.erase(uuid);
+    }
+
+    utils::Uuid
+    SoftwareEngine::createTexture(const utils::Sizef& size,
+                                  const engine::Palette::ColorRole& role)
+    {
+      const int w = std::max(static_cast<int>(std::lround(size.w())), 0);
+      const int h = std::max(static_cast<int>(std::lround(size.h())), 0);
+
+      const std::lock_guard guard(m_locker);
+      return allocateTexture(w, h, role);
+    }
+
+    utils::Uuid
+    SoftwareEngine::createTextureFromFile(const std::string& file,
+                                          const engine::Palette::ColorRole& /*role*/)
+    {
+      error(
+        std::string("Cannot create texture from file \"") + file + "\"",
+        std::string("Images are not supported by the software engine")
+      );
+    }
+
+    utils::Uuid
+    SoftwareEngine::createTextureFromText(const std::string& /*text*/,
+                                          const utils::Uuid& font,
+                                          const engine::Palette::ColorRole& role)
+    {
+      const std::lock_guard guard(m_locker);
+
+      if (m_fonts.find(font) == m_fonts.cend()) {
+        error(
+          std::string("Cannot create texture from text with font ") + font.toString(),
+          std::string("No such font")
+        );
+      }
+
+      return allocateTexture(0, 0, role);
+    }
+
+    void
+    SoftwareEngine::fillTexture(const utils::Uuid& uuid,
+                                const engine::Palette& palette,
+                                const utils::Boxf* area)
+    {
+      const std::lock_guard guard(m_locker);
+
+      Texture& texture = getTextureOrThrow(uuid);
+      const Pixel color = toPixel(palette.getColorForRole(texture.role));
+
+      software::fill(toSurface(texture), toRect(area, texture), color);
+    }
+
+    void
+    SoftwareEngine::drawTexture(const utils::Uuid& tex,
+                                const utils::Boxf* from,
+                                const utils::Uuid* on,
+                                const utils::Boxf* where)
+    {
+      const std::lock_guard guard(m_locker);
+
+      Texture& source = getTextureOrThrow(tex);
+      Texture& target = getTextureOrThrow(on == nullptr ? m_window : *on);
+
+      software::blit(
+        toSurface(source),
+        toRect(from, source),
+        toSurface(target),
+        toRect(where, target),
+        m_scratch
+      );
+    }
+
+    utils::Sizef
+    SoftwareEngine::queryTexture(const utils::Uuid& uuid) {
+      const std::lock_guard guard(m_locker);
+
+      const Texture& texture = getTextureOrThrow(uuid);
+      return utils::Sizef(static_cast<float>(texture.w), static_cast<float>(texture.h));
+    }
+
+    engine::Palette::ColorRole
+    SoftwareEngine::getTextureRole(const utils::Uuid& uuid) {
+      const std::lock_guard guard(m_locker);
+      return getTextureOrThrow(uuid).role;
+    }
+
+    void
+    SoftwareEngine::setTextureRole(const utils::Uuid& uuid,
+                                   const engine::Palette::ColorRole& role)
+    {
+      const std::lock_guard guard(m_locker);
+      getTextureOrThrow(uuid).role = role;
+    }
+
+    void
+    SoftwareEngine::destroyTexture(const utils::Uuid& uuid) {
+      const std::lock_guard guard(m_locker);
+      m_textures.erase(uuid);
+    }
+
+    utils::Uuid
+    SoftwareEngine::createColoredFont(const std::string& /*name*/,
+                                      const engine::Palette& /*palette*/,
+                                      int /*size*/)
+    {
+      const std::lock_guard guard(m_locker);
+
+      const utils::Uuid uuid = utils::Uuid::create();
+      m_fonts.insert(uuid);
+
+      return uuid;
+    }
+
+    void
+    SoftwareEngine::destroyColoredFont(const utils::Uuid& uuid) {
+      const std::lock_guard guard(m_locker);
+      m_fonts.erase(uuid);
+    }
+
+    void
+    SoftwareEngine::populateEvents() {}
+
+    engine::EventShPtr
+    SoftwareEngine::pollEvent(bool& moreEvents) {
+      moreEvents = false;
+      return nullptr;
+    }
+
+    std::vector<SoftwareEngine::Pixel>
+    SoftwareEngine::getPixels(const utils::Uuid& uuid) const {
+      const std::lock_guard guard(m_locker);
+      return getTextureOrThrow(uuid).pixels;
+    }
+
+    utils::Uuid
+    SoftwareEngine::allocateTexture(int w,
+                                    int h,
+                                    const engine::Palette::ColorRole& role)
+    {
+      const utils::Uuid uuid = utils::Uuid::create();
+
+      m_textures.emplace(
+        uuid,
+        Texture{w, h, role, std::vector<Pixel>(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), 0u)}
+      );
+
+      return uuid;
+    }
+
+    SoftwareEngine::Texture&
+    SoftwareEngine::getTextureOrThrow(const utils::Uuid& uuid) {
+      std::unordered_map<utils::Uuid, Texture>::iterator it = m_textures.find(uuid);
+
+      if (it == m_textures.end()) {
+        error(
+          std::string("Cannot retrieve texture ") + uuid.toString(),
+          std::string("No such texture")
+        );
+      }
+
+      return it->second;
+    }
+
+    const SoftwareEngine::Texture&
+    SoftwareEngine::getTextureOrThrow(const utils::Uuid& uuid) const {
+      std::unordered_map<utils::Uuid, Texture>::const_iterator it = m_textures.find(uuid);
+
+      if (it == m_textures.cend()) {
+        error(
+          std::string("Cannot retrieve texture ") + uuid.toString(),
+          std::string("No such texture")
+        );
+      }
+
+      return it->second;
+    }
+
+  }
+}
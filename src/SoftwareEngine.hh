@@ -0,0 +1,350 @@
+#ifndef    SOFTWARE_ENGINE_HH
+# define   SOFTWARE_ENGINE_HH
+
+# include <mutex>
+# include <memory>
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <unordered_set>
+# include <maths_utils/Box.hh>
+# include <maths_utils/Size.hh>
+# include <core_utils/Uuid.hh>
+# include <core_utils/CoreObject.hh>
+# include <sdl_engine/Color.hh>
+# include <sdl_engine/Engine.hh>
+# include <sdl_engine/Palette.hh>
+# include "SoftwareKernels.hh"
+
+namespace sdl {
+  namespace core {
+
+    class SoftwareEngine: public utils::CoreObject, public engine::Engine {
+      public:
+
+        /**
+         * @brief - Convenience define to refer to a pixel of the textures.
+         */
+        using Pixel = software::Pixel;
+
+        /**
+         * @brief - Creates an engine which keeps its textures in memory as plain arrays
+         *          of pixels: this allows to render widgets without any display, for
+         *          example by assigning this engine to a root widget through the method
+         *          `SdlWidget::setEngine`. Areas are expressed in engine format (i.e.
+         *          the center of the area relatively to the top left corner of the
+         *          texture, with the `y` axis pointing downwards).
+         *          The fill and blit operations use vectorized kernels when supported
+         *          by the processor.
+         *          Windows are backed by a texture: the last created window is used
+         *          when drawing a texture without specifying a target. This engine does
+         *          not produce any event and does not render text.
+         */
+        SoftwareEngine();
+
+        ~SoftwareEngine() = default;
+
+        /**
+         * @brief - Creates a window backed by a texture with the specified size. The new
+         *          window becomes the default target of `drawTexture`.
+         * @param size - the size of the window.
+         * @param title - the title of the window, unused.
+         * @return - the identifier of the window.
+         */
+        utils::Uuid
+        createWindow(const utils::Sizei& size,
+                     const std::string& title) override;
+
+        /**
+         * @brief - Does nothing: software windows do not have an icon.
+         */
+        void
+        setWindowIcon(const utils::Uuid& uuid,
+                      const std::string& icon) override;
+
+        /**
+         * @brief - Fills the content of the window with transparent black. Raises an
+         *          error if the window does not exist.
+         * @param uuid - the window to clear.
+         */
+        void
+        clearWindow(const utils::Uuid& uuid) override;
+
+        /**
+         * @brief - Does nothing: the content of a window can be retrieved at any time
+         *          through `getPixels`. Raises an error if the window does not exist.
+         * @param uuid - the window to render.
+         */
+        void
+        renderWindow(const utils::Uuid& uuid) override;
+
+        /**
+         * @brief - Destroys the window and its content.
+         * @param uuid - the window to destroy.
+         */
+        void
+        destroyWindow(const utils::Uuid& uuid) override;
+
+        /**
+         * @brief - Creates a new texture with the specified size and color role. The
+         *          content of the texture is transparent black.
+         * @param size - the size of the texture to create, rounded to the nearest pixel.
+         * @param role - the color role of the texture.
+         * @return - the identifier of the texture.
+         */
+        utils::Uuid
+        createTexture(const utils::Sizef& size,
+                      const engine::Palette::ColorRole& role) override;
+
+        /**
+         * @brief - Images are not supported by this engine: raises an error.
+         */
+        utils::Uuid
+        createTextureFromFile(const std::string& file,
+                              const engine::Palette::ColorRole& role) override;
+
+        /**
+         * @brief - Text is not rendered by this engine: an empty texture is created so
+         *          that widgets displaying text can still be laid out and drawn. Raises
+         *          an error if the font does not exist.
+         * @param text - the text to render, unused.
+         * @param font - the font to use to render the text.
+         * @param role - the color role of the texture.
+         * @return - the identifier of the texture.
+         */
+        utils::Uuid
+        createTextureFromText(const std::string& text,
+                              const utils::Uuid& font,
+                              const engine::Palette::ColorRole& role) override;
+
+        /**
+         * @brief - Fills the specified area of the texture with the color defined by the
+         *          palette for the role of the texture. The area is clipped to the size
+         *          of the texture. Raises an error if the texture does not exist.
+         * @param uuid - the texture to fill.
+         * @param palette - the palette to use to determine the color of the texture.
+         * @param area - the area to fill or `null` to fill the whole texture.
+         */
+        void
+        fillTexture(const utils::Uuid& uuid,
+                    const engine::Palette& palette,
+                    const utils::Boxf* area = nullptr) override;
+
+        /**
+         * @brief - Draws the `from` area of the texture `tex` onto the `where` area of
+         *          the texture `on`. The source pixels are blended over the existing
+         *          content using their alpha channel. If the areas have different sizes
+         *          the source is scaled using the nearest pixel. A texture can be drawn
+         *          onto itself, even if both areas overlap.
+         *          Both areas are clipped to the size of their texture. Raises an error
+         *          if any of the textures does not exist.
+         * @param tex - the texture to draw.
+         * @param from - the area of `tex` to draw or `null` to draw the whole texture.
+         * @param on - the texture onto which `tex` should be drawn or `null` to draw on
+         *             the last created window.
+         * @param where - the area of `on` where the texture should be drawn or `null` to
+         *                use the whole texture.
+         */
+        void
+        drawTexture(const utils::Uuid& tex,
+                    const utils::Boxf* from = nullptr,
+                    const utils::Uuid* on = nullptr,
+                    const utils::Boxf* where = nullptr) override;
+
+        /**
+         * @brief - Retrieves the size of the texture. Raises an error if the texture does
+         *          not exist.
+         * @param uuid - the texture to query.
+         * @return - the size of the texture in pixels.
+         */
+        utils::Sizef
+        queryTexture(const utils::Uuid& uuid) override;
+
+        /**
+         * @brief - Retrieves the color role of the texture. Raises an error if the texture
+         *          does not exist.
+         * @param uuid - the texture to query.
+         * @return - the color role of the texture.
+         */
+        engine::Palette::ColorRole
+        getTextureRole(const utils::Uuid& uuid) override;
+
+        /**
+         * @brief - Assigns a new color role to the texture. The content of the texture is
+         *          not modified. Raises an error if the texture does not exist.
+         * @param uuid - the texture to update.
+         * @param role - the new color role of the texture.
+         */
+        void
+        setTextureRole(const utils::Uuid& uuid,
+                       const engine::Palette::ColorRole& role) override;
+
+        /**
+         * @brief - Destroys the texture. Invalid or unknown identifiers are ignored.
+         * @param uuid - the texture to destroy.
+         */
+        void
+        destroyTexture(const utils::Uuid& uuid) override;
+
+        /**
+         * @brief - Registers a font which can be used to create textures from text. The
+         *          font file is not loaded.
+         * @param name - the name of the font, unused.
+         * @param palette - the palette of the font, unused.
+         * @param size - the size of the font, unused.
+         * @return - the identifier of the font.
+         */
+        utils::Uuid
+        createColoredFont(const std::string& name,
+                          const engine::Palette& palette,
+                          int size = 10) override;
+
+        /**
+         * @brief - Unregisters the font. Unknown identifiers are ignored.
+         * @param uuid - the font to destroy.
+         */
+        void
+        destroyColoredFont(const utils::Uuid& uuid) override;
+
+        /**
+         * @brief - Does nothing: there is no system to gather events from.
+         */
+        void
+        populateEvents() override;
+
+        /**
+         * @brief - Never produces any event.
+         * @param moreEvents - set to `false`.
+         * @return - a `null` event.
+         */
+        engine::EventShPtr
+        pollEvent(bool& moreEvents) override;
+
+        /**
+         * @brief - Copies the pixels of the texture, row by row starting from the top left
+         *          corner. Raises an error if the texture does not exist.
+         * @param uuid - the texture to read.
+         * @return - the pixels of the texture.
+         */
+        std::vector<Pixel>
+        getPixels(const utils::Uuid& uuid) const;
+
+        /**
+         * @brief - Returns the number of textures currently allocated in this engine,
+         *          including the ones backing the windows.
+         * @return - the number of textures.
+         */
+        unsigned
+        getTexturesCount() const noexcept;
+
+        /**
+         * @brief - Returns the name of the kernels used to fill and blit the textures: this
+         *          depends on the instruction sets supported by the processor.
+         * @return - a string describing the kernels used by this engine.
+         */
+        static
+        const char*
+        getKernelsName() noexcept;
+
+        /**
+         * @brief - Converts the input color into a pixel value.
+         * @param color - the color to convert.
+         * @return - the corresponding pixel.
+         */
+        static
+        Pixel
+        toPixel(const engine::Color& color) noexcept;
+
+      private:
+
+        /**
+         * @brief - Describes a texture of the engine.
+         */
+        struct Texture {
+          int w;
+          int h;
+          engine::Palette::ColorRole role;
+          std::vector<Pixel> pixels;
+        };
+
+        /**
+         * @brief - Creates a texture with the specified dimensions, filled with
+         *          transparent black.
+         *          Assumes that the `m_locker` is already acquired.
+         * @param w - the width of the texture.
+         * @param h - the height of the texture.
+         * @param role - the color role of the texture.
+         * @return - the identifier of the texture.
+         */
+        utils::Uuid
+        allocateTexture(int w,
+                        int h,
+                        const engine::Palette::ColorRole& role);
+
+        /**
+         * @brief - Retrieves the texture associated to the identifier or raises an error
+         *          if it does not exist.
+         *          Assumes that the `m_locker` is already acquired.
+         * @param uuid - the identifier of the texture.
+         * @return - the corresponding texture.
+         */
+        Texture&
+        getTextureOrThrow(const utils::Uuid& uuid);
+
+        const Texture&
+        getTextureOrThrow(const utils::Uuid& uuid) const;
+
+        /**
+         * @brief - Converts the input area in engine format into a rectangle of pixels for
+         *          the texture. A `null` area corresponds to the whole texture. Note that
+         *          the returned rectangle is not clipped.
+         * @param area - the area to convert.
+         * @param texture - the texture into which the area is expressed.
+         * @return - the rectangle of pixels corresponding to the area.
+         */
+        static
+        software::Rect
+        toRect(const utils::Boxf* area,
+               const Texture& texture) noexcept;
+
+        static
+        software::Surface
+        toSurface(Texture& texture) noexcept;
+
+      private:
+
+        /**
+         * @brief - The textures of the engine, including the ones backing the windows.
+         */
+        std::unordered_map<utils::Uuid, Texture> m_textures;
+
+        /**
+         * @brief - The window used when drawing a texture without target. Invalid if no
+         *          window has been created.
+         */
+        utils::Uuid m_window;
+
+        /**
+         * @brief - The fonts registered in this engine.
+         */
+        std::unordered_set<utils::Uuid> m_fonts;
+
+        /**
+         * @brief - Buffer used when a texture is drawn onto itself: it is kept from one
+         *          draw operation to the next to reuse its storage.
+         */
+        std::vector<Pixel> m_scratch;
+
+        /**
+         * @brief - Protects the textures from concurrent accesses.
+         */
+        mutable std::mutex m_locker;
+    };
+
+    using SoftwareEngineShPtr = std::shared_ptr<SoftwareEngine>;
+  }
+}
+
+# include "SoftwareEngine.hxx"
+
+#endif    /* SOFTWARE_ENGINE_HH */
@@ -0,0 +1,65 @@
+#ifndef    SOFTWARE_ENGINE_HXX
+# define   SOFTWARE_ENGINE_HXX
+
+# include "SoftwareEngine.hh"
+# include <cmath>
+# include <algorithm>
+
+namespace sdl {
+  namespace core {
+
+    inline
+    unsigned
+    SoftwareEngine::getTexturesCount() const noexcept {
+      const std::lock_guard guard(m_locker);
+      return m_textures.size();
+    }
+
+    inline
+    const char*
+    SoftwareEngine::getKernelsName() noexcept {
+      return software::getKernelsName();
+    }
+
+    inline
+    SoftwareEngine::Pixel
+    SoftwareEngine::toPixel(const engine::Color& color) noexcept {
+      const auto channel = [](float value) {
+        return static_cast<Pixel>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+      };
+
+      return
+        channel(color.r()) |
+        (channel(color.g()) << 8u) |
+        (channel(color.b()) << 16u) |
+        (channel(color.a()) << 24u)
+      ;
+    }
+
+    inline
+    software::Rect
+    SoftwareEngine::toRect(const utils::Boxf* area,
+                           const Texture& texture) noexcept
+    {
+      if (area == nullptr) {
+        return software::Rect{0, 0, texture.w, texture.h};
+      }
+
+      return software::Rect{
+        static_cast<int>(std::lround(area->x() - area->w() / 2.0f)),
+        static_cast<int>(std::lround(area->y() - area->h() / 2.0f)),
+        static_cast<int>(std::lround(area->w())),
+        static_cast<int>(std::lround(area->h()))
+      };
+    }
+
+    inline
+    software::Surface
+    SoftwareEngine::toSurface(Texture& texture) noexcept {
+      return software::Surface{texture.pixels.data(), texture.w, texture.h};
+    }
+
+  }
+}
+
+#endif    /* SOFTWARE_ENGINE_HXX */
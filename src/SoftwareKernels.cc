@@ -0,0 +1,402 @@
+
+# include "SoftwareKernels.hh"
+# include <algorithm>
+
+# if defined(__SSE2__) || (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+#  include <immintrin.h>
+# endif
+
+namespace {
+
+  using Pixel = sdl::core::software::Pixel;
+
+  /**
+   * @brief - Number of pixels gathered before being blended when the source
+   *          of a blit has to be scaled.
+   */
+  constexpr unsigned ChunkSize = 256u;
+
+  /**
+   * @brief - Kernel used to fill `count` pixels starting at `dst` with the `color`.
+   */
+  using FillKernel = void (*)(Pixel* dst, unsigned count, Pixel color);
+
+  /**
+   * @brief - Kernel used to blend `count` pixels from `src` over the pixels at `dst`
+   *          using the alpha channel of the source pixels.
+   */
+  using BlendKernel = void (*)(Pixel* dst, const Pixel* src, unsigned count);
+
+  /**
+   * @brief - Divides the input value by 255 with rounding: this is exact for any value
+   *          in the range `[0; 65535]`. The vectorized kernels use the same formula so
+   *          that all the kernels produce the same results.
+   */
+  inline
+  unsigned
+  div255(unsigned value) noexcept {
+    value += 128u;
+    return (value + (value >> 8u)) >> 8u;
+  }
+
+  void
+  fillScalar(Pixel* dst,
+             unsigned count,
+             Pixel color)
+  {
+    std::fill(dst, dst + count, color);
+  }
+
+  void
+  blendScalar(Pixel* dst,
+              const Pixel* src,
+              unsigned count)
+  {
+    for (unsigned id = 0u ; id < count ; ++id) {
+      const Pixel s = src[id];
+      const unsigned alpha = s >> 24u;
+
+      // Handle the trivial cases first: they are exact with the general
+      // formula as well.
+      if (alpha == 255u) {
+        dst[id] = s;
+        continue;
+      }
+      if (alpha == 0u) {
+        continue;
+      }
+
+      const Pixel d = dst[id];
+      const unsigned inv = 255u - alpha;
+      Pixel out = 0u;
+
+      for (unsigned channel = 0u ; channel < 4u ; ++channel) {
+        const unsigned shift = channel * 8u;
+        const unsigned sc = (s >> shift) & 0xFFu;
+        const unsigned dc = (d >> shift) & 0xFFu;
+
+        // The alpha channel of the source is not premultiplied.
+        const unsigned factor = (channel == 3u ? 255u : alpha);
+
+        out |= div255(sc * factor + dc * inv) << shift;
+      }
+
+      dst[id] = out;
+    }
+  }
+
+# if defined(__SSE2__)
+
+  void
+  fillSse2(Pixel* dst,
+           unsigned count,
+           Pixel color)
+  {
+    const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+
+    unsigned id = 0u;
+    for ( ; id + 4u <= count ; id += 4u) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + id), value);
+    }
+
+    fillScalar(dst + id, count - id, color);
+  }
+
+  /**
+   * @brief - Blends two pixels expanded to 16 bits per channel.
+   */
+  inline
+  __m128i
+  blendSse2Pair(__m128i s16,
+                __m128i d16) noexcept
+  {
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i rgbMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+
+    // Broadcast the alpha of each pixel to all its channels: the source
+    // factor of the alpha channel itself is one.
+    const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i sf = _mm_or_si128(_mm_and_si128(alpha, rgbMask), alphaOne);
+    const __m128i df = _mm_sub_epi16(full, alpha);
+
+    __m128i v = _mm_add_epi16(_mm_mullo_epi16(s16, sf), _mm_mullo_epi16(d16, df));
+    v = _mm_add_epi16(v, half);
+    return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+  }
+
+  void
+  blendSse2(Pixel* dst,
+            const Pixel* src,
+            unsigned count)
+  {
+    const __m128i zero = _mm_setzero_si128();
+
+    unsigned id = 0u;
+    for ( ; id + 4u <= count ; id += 4u) {
+      const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + id));
+      const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + id));
+
+      const __m128i lo = blendSse2Pair(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+      const __m128i hi = blendSse2Pair(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + id), _mm_packus_epi16(lo, hi));
+    }
+
+    blendScalar(dst + id, src + id, count - id);
+  }
+
+# endif
+
+# if defined(__SSE2__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define SOFTWARE_KERNELS_AVX2
+
+  __attribute__((target("avx2")))
+  void
+  fillAvx2(Pixel* dst,
+           unsigned count,
+           Pixel color)
+  {
+    const __m256i value = _mm256_set1_epi32(static_cast<int>(color));
+
+    unsigned id = 0u;
+    for ( ; id + 8u <= count ; id += 8u) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + id), value);
+    }
+
+    fillSse2(dst + id, count - id, color);
+  }
+
+  __attribute__((target("avx2")))
+  inline
+  __m256i
+  blendAvx2Quad(__m256i s16,
+                __m256i d16) noexcept
+  {
+    // Same computation as `blendSse2Pair` on four pixels at once: the
+    // unpack and shuffle instructions operate on each 128 bits lane.
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i half = _mm256_set1_epi16(128);
+    const __m256i rgbMask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+    const __m256i alphaOne = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+
+    const __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    const __m256i sf = _mm256_or_si256(_mm256_and_si256(alpha, rgbMask), alphaOne);
+    const __m256i df = _mm256_sub_epi16(full, alpha);
+
+    __m256i v = _mm256_add_epi16(_mm256_mullo_epi16(s16, sf), _mm256_mullo_epi16(d16, df));
+    v = _mm256_add_epi16(v, half);
+    return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+  }
+
+  __attribute__((target("avx2")))
+  void
+  blendAvx2(Pixel* dst,
+            const Pixel* src,
+            unsigned count)
+  {
+    const __m256i zero = _mm256_setzero_si256();
+
+    unsigned id = 0u;
+    for ( ; id + 8u <= count ; id += 8u) {
+      const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + id));
+      const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + id));
+
+      const __m256i lo = blendAvx2Quad(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+      const __m256i hi = blendAvx2Quad(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + id), _mm256_packus_epi16(lo, hi));
+    }
+
+    blendSse2(dst + id, src + id, count - id);
+  }
+
+# endif
+
+  /**
+   * @brief - The set of kernels used to fill and blend pixels.
+   */
+  struct Kernels {
+    const char* name;
+    FillKernel fill;
+    BlendKernel blend;
+  };
+
+  Kernels
+  selectKernels() noexcept {
+# if defined(SOFTWARE_KERNELS_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+      return Kernels{"avx2", &fillAvx2, &blendAvx2};
+    }
+# endif
+
+# if defined(__SSE2__)
+    return Kernels{"sse2", &fillSse2, &blendSse2};
+# else
+    return Kernels{"scalar", &fillScalar, &blendScalar};
+# endif
+  }
+
+  /**
+   * @brief - Retrieves the kernels to use: they are selected once based on the features
+   *          of the processor.
+   */
+  const Kernels&
+  getKernels() noexcept {
+    static const Kernels kernels = selectKernels();
+    return kernels;
+  }
+
+}
+
+namespace sdl {
+  namespace core {
+    namespace software {
+
+      void
+      fill(const Surface& target,
+           const Rect& area,
+           Pixel color) noexcept
+      {
+        const int left = std::max(area.x, 0);
+        const int right = std::min(area.x + area.w, target.w);
+        const int top = std::max(area.y, 0);
+        const int bottom = std::min(area.y + area.h, target.h);
+
+        if (left >= right || top >= bottom) {
+          return;
+        }
+
+        const FillKernel kernel = getKernels().fill;
+
+        for (int row = top ; row < bottom ; ++row) {
+          kernel(target.pixels + row * target.w + left, right - left, color);
+        }
+      }
+
+      void
+      blend(Pixel* dst,
+            const Pixel* src,
+            unsigned count) noexcept
+      {
+        getKernels().blend(dst, src, count);
+      }
+
+      void
+      blit(const Surface& source,
+           const Rect& from,
+           const Surface& target,
+           const Rect& where,
+           std::vector<Pixel>& scratch)
+      {
+        if (from.w <= 0 || from.h <= 0 || where.w <= 0 || where.h <= 0) {
+          return;
+        }
+
+        // Clip the destination area to the target surface: each pixel of
+        // the destination is then mapped to the nearest pixel of the source
+        // area.
+        const int left = std::max(where.x, 0);
+        const int right = std::min(where.x + where.w, target.w);
+        const int top = std::max(where.y, 0);
+        const int bottom = std::min(where.y + where.h, target.h);
+
+        if (left >= right || top >= bottom) {
+          return;
+        }
+
+        Surface src = source;
+        Rect area = from;
+
+        // When drawing a surface onto itself the rows of the source could
+        // be overwritten before being read: we copy the part of the source
+        // which is available into the scratch buffer and read from there.
+        if (source.pixels == target.pixels) {
+          const int sl = std::max(from.x, 0);
+          const int sr = std::min(from.x + from.w, source.w);
+          const int st = std::max(from.y, 0);
+          const int sb = std::min(from.y + from.h, source.h);
+
+          if (sl >= sr || st >= sb) {
+            return;
+          }
+
+          scratch.resize(static_cast<std::size_t>(sr - sl) * static_cast<std::size_t>(sb - st));
+
+          for (int row = st ; row < sb ; ++row) {
+            const Pixel* line = source.pixels + row * source.w;
+            std::copy(line + sl, line + sr, scratch.data() + (row - st) * (sr - sl));
+          }
+
+          src = Surface{scratch.data(), sr - sl, sb - st};
+          area.x -= sl;
+          area.y -= st;
+        }
+
+        const BlendKernel kernel = getKernels().blend;
+
+        // When the areas have the same width the rows of the source can be
+        // blended directly. Otherwise the pixels are gathered in chunks.
+        const bool direct = (area.w == where.w);
+        Pixel chunk[ChunkSize];
+
+        for (int row = top ; row < bottom ; ++row) {
+          const int srcRow = area.y + static_cast<int>((static_cast<long>(row - where.y) * area.h) / where.h);
+          if (srcRow < 0 || srcRow >= src.h) {
+            continue;
+          }
+
+          const Pixel* srcLine = src.pixels + srcRow * src.w;
+          Pixel* dstLine = target.pixels + row * target.w;
+
+          if (direct) {
+            // Restrict the columns to the ones available in the source.
+            const int first = std::max(left, where.x - area.x);
+            const int last = std::min(right, where.x - area.x + src.w);
+
+            if (first < last) {
+              kernel(dstLine + first, srcLine + (first - where.x + area.x), last - first);
+            }
+
+            continue;
+          }
+
+          // As the mapping is monotonic the columns available in the source
+          // form a contiguous range.
+          int first = left;
+          unsigned count = 0u;
+
+          for (int col = left ; col < right ; ++col) {
+            const int srcCol = area.x + static_cast<int>((static_cast<long>(col - where.x) * area.w) / where.w);
+            if (srcCol < 0 || srcCol >= src.w) {
+              continue;
+            }
+
+            if (count == 0u) {
+              first = col;
+            }
+
+            chunk[count] = srcLine[srcCol];
+            ++count;
+
+            if (count == ChunkSize) {
+              kernel(dstLine + first, chunk, count);
+              count = 0u;
+            }
+          }
+
+          if (count > 0u) {
+            kernel(dstLine + first, chunk, count);
+          }
+        }
+      }
+
+      const char*
+      getKernelsName() noexcept {
+        return getKernels().name;
+      }
+
+    }
+  }
+}
@@ -0,0 +1,96 @@
+#ifndef    SOFTWARE_KERNELS_HH
+# define   SOFTWARE_KERNELS_HH
+
+# include <vector>
+# include <cstdint>
+
+namespace sdl {
+  namespace core {
+    namespace software {
+
+      /**
+       * @brief - Describes a pixel as stored in the software textures: the red, green,
+       *          blue and alpha channels are stored in this order in memory, with one
+       *          byte per channel.
+       */
+      using Pixel = std::uint32_t;
+
+      /**
+       * @brief - Describes an array of pixels stored row by row starting from the top
+       *          left corner.
+       */
+      struct Surface {
+        Pixel* pixels;
+        int w;
+        int h;
+      };
+
+      /**
+       * @brief - Describes a rectangle of pixels through its top left corner and its
+       *          dimensions. A rectangle may extend beyond the surface it refers to.
+       */
+      struct Rect {
+        int x;
+        int y;
+        int w;
+        int h;
+      };
+
+      /**
+       * @brief - Fills the area of the surface with the input color. The area is clipped
+       *          to the surface.
+       * @param target - the surface to fill.
+       * @param area - the area to fill.
+       * @param color - the color to fill the area with.
+       */
+      void
+      fill(const Surface& target,
+           const Rect& area,
+           Pixel color) noexcept;
+
+      /**
+       * @brief - Blends `count` pixels from `src` over the pixels at `dst` using the
+       *          alpha channel of the source pixels. Both ranges should not overlap.
+       * @param dst - the pixels to blend onto.
+       * @param src - the pixels to blend.
+       * @param count - the number of pixels to blend.
+       */
+      void
+      blend(Pixel* dst,
+            const Pixel* src,
+            unsigned count) noexcept;
+
+      /**
+       * @brief - Blends the `from` area of the `source` over the `where` area of the
+       *          `target`. If the areas have different sizes the source is scaled using
+       *          the nearest pixel. Both areas are clipped to their surface.
+       *          The `source` and the `target` can be the same surface: in this case the
+       *          source area is first copied into the `scratch` buffer so that the
+       *          overlapping rows are not read after being written.
+       * @param source - the surface to read from.
+       * @param from - the area of the source to blend.
+       * @param target - the surface to blend onto.
+       * @param where - the area of the target to blend onto.
+       * @param scratch - a buffer used when both surfaces are the same, which can be
+       *                  reused from one call to the next to avoid allocations.
+       */
+      void
+      blit(const Surface& source,
+           const Rect& from,
+           const Surface& target,
+           const Rect& where,
+           std::vector<Pixel>& scratch);
+
+      /**
+       * @brief - Returns the name of the kernels used to fill and blend the pixels: this
+       *          depends on the instruction sets supported by the processor.
+       * @return - a string describing the kernels in use.
+       */
+      const char*
+      getKernelsName() noexcept;
+
+    }
+  }
+}
+
+#endif    /* SOFTWARE_KERNELS_HH */
@@ -0,0 +1,224 @@
+#ifndef    SPATIAL_INDEX_HH
+# define   SPATIAL_INDEX_HH
+
+# include <vector>
+# include <unordered_map>
+# include <maths_utils/Box.hh>
+# include <maths_utils/Vector2.hh>
+
+namespace sdl {
+  namespace core {
+
+    template <typename Item, typename Priority>
+    class SpatialIndex {
+      public:
+
+        /**
+         * @brief - Creates an empty spatial index. Items are registered, moved and
+         *          removed individually through the `update` and `remove` methods:
+         *          the index is organized as a balanced tree of bounding boxes so
+         *          that each of these operations along with a query only costs a
+         *          logarithmic amount of time in the number of items.
+         *          Note that the index is not thread safe: callers are expected
+         *          to provide the needed synchronization.
+         */
+        SpatialIndex();
+
+        ~SpatialIndex() = default;
+
+        /**
+         * @brief - Removes all the items registered in this index.
+         */
+        void
+        clear() noexcept;
+
+        /**
+         * @brief - Registers the input item in this index or updates its area and its
+         *          priority if it is already registered. When several items span the
+         *          same position they are visited by descending order of priority.
+         *          Items with an invalid area are considered to potentially span any
+         *          position and are always visited.
+         * @param item - the item to register.
+         * @param area - the area spanned by the item.
+         * @param priority - the priority of the item.
+         */
+        void
+        update(Item item,
+               const utils::Boxf& area,
+               const Priority& priority);
+
+        /**
+         * @brief - Removes the input item from this index. Nothing happens if the item
+         *          is not registered.
+         * @param item - the item to remove.
+         */
+        void
+        remove(Item item);
+
+        /**
+         * @brief - Retrieves the union of the areas of the items registered in this
+         *          index which have a valid area. If no such item exists an invalid
+         *          area is returned.
+         * @return - the bounding box of the items of this index.
+         */
+        utils::Boxf
+        getBounds() const noexcept;
+
+        /**
+         * @brief - Used to determine whether all the items registered in this index
+         *          have a valid area.
+         * @return - `true` if no item registered in this index is unbounded.
+         */
+        bool
+        isBounded() const noexcept;
+
+        /**
+         * @brief - Visits the items spanning the input position by descending order
+         *          of priority. The `visitor` is called for each item and should return
+         *          `true` to stop the traversal. The candidates are collected in some
+         *          internal buffers which are reused from one query to the next.
+         * @param pos - the position for which items should be visited.
+         * @param visitor - the callable to invoke on each item spanning the position.
+         * @return - `true` if the traversal was stopped by the visitor and `false` if
+         *           all the items spanning the position have been visited.
+         */
+        template <typename Visitor>
+        bool
+        visit(const utils::Vector2f& pos,
+              Visitor visitor) const;
+
+      private:
+
+        /**
+         * @brief - Describes a node of the tree. Leaves hold an item while internal
+         *          nodes always have two children and span the union of their areas.
+         *          Nodes which are not used are chained through their `parent`.
+         *          Unbounded items are stored in leaves which are not attached to the
+         *          tree.
+         */
+        struct Node {
+          float left;
+          float right;
+          float bottom;
+          float top;
+
+          int parent;
+          int first;
+          int second;
+          int height;
+
+          Item item;
+          Priority priority;
+        };
+
+        /**
+         * @brief - Value used to represent the absence of node.
+         */
+        static constexpr int null = -1;
+
+        int
+        allocateNode();
+
+        void
+        releaseNode(int node) noexcept;
+
+        /**
+         * @brief - Attaches the input leaf in the tree, next to the node which leads to
+         *          the smallest increase of the perimeter of the bounding boxes.
+         * @param leaf - the leaf to attach.
+         */
+        void
+        insertLeaf(int leaf);
+
+        /**
+         * @brief - Detaches the input leaf from the tree.
+         * @param leaf - the leaf to detach.
+         */
+        void
+        removeLeaf(int leaf) noexcept;
+
+        /**
+         * @brief - Walks up the tree from the input node and updates the bounding box
+         *          and the height of each node, rotating them when needed to keep the
+         *          tree balanced.
+         * @param node - the first node to update.
+         */
+        void
+        refit(int node) noexcept;
+
+        /**
+         * @brief - Performs a rotation around the input node if its children have a
+         *          too different height.
+         * @param node - the node to balance.
+         * @return - the index of the node which replaced the input one in the tree.
+         */
+        int
+        balance(int node) noexcept;
+
+        /**
+         * @brief - Assigns to the input node the union of the areas of the two other
+         *          nodes along with the corresponding height.
+         * @param node - the node to update.
+         * @param lhs - the first node to merge.
+         * @param rhs - the second node to merge.
+         */
+        void
+        merge(int node,
+              int lhs,
+              int rhs) noexcept;
+
+        bool
+        isLeaf(int node) const noexcept;
+
+        static
+        bool
+        contains(const Node& node,
+                 const utils::Vector2f& pos) noexcept;
+
+        /**
+         * @brief - Computes the perimeter of the union of the areas of the two nodes.
+         * @param lhs - the first node.
+         * @param rhs - the second node.
+         * @return - the perimeter of the union of both areas.
+         */
+        static
+        float
+        perimeter(const Node& lhs,
+                  const Node& rhs) noexcept;
+
+      private:
+
+        /**
+         * @brief - The nodes of the tree, along with the root of the tree and the head
+         *          of the list of unused nodes.
+         */
+        std::vector<Node> m_nodes;
+        int m_root;
+        int m_free;
+
+        /**
+         * @brief - Associates each item to the leaf holding it.
+         */
+        std::unordered_map<Item, int> m_leaves;
+
+        /**
+         * @brief - The leaves holding an item which does not have a valid area. These
+         *          are not part of the tree and are visited for any position.
+         */
+        std::vector<int> m_unbounded;
+
+        /**
+         * @brief - Buffers used to traverse the tree and to sort the candidates of a
+         *          query: they are kept from one query to the next to reuse their
+         *          storage.
+         */
+        mutable std::vector<int> m_stack;
+        mutable std::vector<int> m_candidates;
+    };
+
+  }
+}
+
+# include "SpatialIndex.hxx"
+
+#endif    /* SPATIAL_INDEX_HH */
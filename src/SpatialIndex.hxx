@@ -0,0 +1,423 @@
+#ifndef    SPATIAL_INDEX_HXX
+# define   SPATIAL_INDEX_HXX
+
+# include "SpatialIndex.hh"
+# include <algorithm>
+
+namespace sdl {
+  namespace core {
+
+    template <typename Item, typename Priority>
+    inline
+    SpatialIndex<Item, Priority>::SpatialIndex():
+      m_nodes(),
+      m_root(null),
+      m_free(null),
+      m_leaves(),
+      m_unbounded(),
+      m_stack(),
+      m_candidates()
+    {}
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::clear() noexcept {
+      m_nodes.clear();
+      m_root = null;
+      m_free = null;
+
+      m_leaves.clear();
+      m_unbounded.clear();
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::update(Item item,
+                                         const utils::Boxf& area,
+                                         const Priority& priority)
+    {
+      // Retrieve the leaf holding the item or create it. Existing leaves
+      // are detached from the tree before being updated.
+      typename std::unordered_map<Item, int>::iterator it = m_leaves.find(item);
+      int leaf = null;
+
+      if (it == m_leaves.end()) {
+        leaf = allocateNode();
+        m_leaves.emplace(item, leaf);
+      }
+      else {
+        leaf = it->second;
+
+        if (m_nodes[leaf].height < 0) {
+          m_unbounded.erase(std::find(m_unbounded.begin(), m_unbounded.end(), leaf));
+        }
+        else {
+          removeLeaf(leaf);
+        }
+      }
+
+      Node& node = m_nodes[leaf];
+
+      node.left = area.x() - area.w() / 2.0f;
+      node.right = area.x() + area.w() / 2.0f;
+      node.bottom = area.y() - area.h() / 2.0f;
+      node.top = area.y() + area.h() / 2.0f;
+      node.parent = null;
+      node.first = null;
+      node.second = null;
+      node.item = item;
+      node.priority = priority;
+
+      // Unbounded leaves are flagged with a negative height.
+      if (!area.valid()) {
+        node.height = -1;
+        m_unbounded.push_back(leaf);
+        return;
+      }
+
+      node.height = 0;
+      insertLeaf(leaf);
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::remove(Item item) {
+      typename std::unordered_map<Item, int>::iterator it = m_leaves.find(item);
+      if (it == m_leaves.end()) {
+        return;
+      }
+
+      const int leaf = it->second;
+      m_leaves.erase(it);
+
+      if (m_nodes[leaf].height < 0) {
+        m_unbounded.erase(std::find(m_unbounded.begin(), m_unbounded.end(), leaf));
+      }
+      else {
+        removeLeaf(leaf);
+      }
+
+      releaseNode(leaf);
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    utils::Boxf
+    SpatialIndex<Item, Priority>::getBounds() const noexcept {
+      if (m_root == null) {
+        return utils::Boxf();
+      }
+
+      const Node& root = m_nodes[m_root];
+
+      return utils::Boxf(
+        (root.left + root.right) / 2.0f,
+        (root.bottom + root.top) / 2.0f,
+        root.right - root.left,
+        root.top - root.bottom
+      );
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    bool
+    SpatialIndex<Item, Priority>::isBounded() const noexcept {
+      return m_unbounded.empty();
+    }
+
+    template <typename Item, typename Priority>
+    template <typename Visitor>
+    inline
+    bool
+    SpatialIndex<Item, Priority>::visit(const utils::Vector2f& pos,
+                                        Visitor visitor) const
+    {
+      // Collect the leaves spanning the position: only the branches of the
+      // tree which contain the position are traversed.
+      m_candidates.clear();
+      m_stack.clear();
+
+      if (m_root != null) {
+        m_stack.push_back(m_root);
+      }
+
+      while (!m_stack.empty()) {
+        const int id = m_stack.back();
+        m_stack.pop_back();
+
+        const Node& node = m_nodes[id];
+        if (!contains(node, pos)) {
+          continue;
+        }
+
+        if (isLeaf(id)) {
+          m_candidates.push_back(id);
+          continue;
+        }
+
+        m_stack.push_back(node.first);
+        m_stack.push_back(node.second);
+      }
+
+      m_candidates.insert(m_candidates.end(), m_unbounded.cbegin(), m_unbounded.cend());
+
+      // Visit the candidates by descending order of priority.
+      std::sort(m_candidates.begin(), m_candidates.end(),
+        [this](int lhs, int rhs) {
+          return m_nodes[rhs].priority < m_nodes[lhs].priority;
+        }
+      );
+
+      for (std::vector<int>::const_iterator id = m_candidates.cbegin() ; id != m_candidates.cend() ; ++id) {
+        if (visitor(m_nodes[*id].item)) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    int
+    SpatialIndex<Item, Priority>::allocateNode() {
+      if (m_free == null) {
+        m_nodes.push_back(Node());
+        return static_cast<int>(m_nodes.size()) - 1;
+      }
+
+      const int node = m_free;
+      m_free = m_nodes[node].parent;
+
+      return node;
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::releaseNode(int node) noexcept {
+      m_nodes[node].parent = m_free;
+      m_nodes[node].item = Item();
+      m_nodes[node].priority = Priority();
+
+      m_free = node;
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::insertLeaf(int leaf) {
+      if (m_root == null) {
+        m_root = leaf;
+        return;
+      }
+
+      // Descend the tree to find the best sibling for the leaf: at each
+      // step we compare the cost of creating a new parent for the current
+      // node with the cost of descending in either of its children. The
+      // cost is the perimeter of the bounding boxes created or enlarged.
+      int sibling = m_root;
+
+      while (!isLeaf(sibling)) {
+        const Node& node = m_nodes[sibling];
+        const Node& first = m_nodes[node.first];
+        const Node& second = m_nodes[node.second];
+
+        const float combined = perimeter(node, m_nodes[leaf]);
+        const float cost = 2.0f * combined;
+        const float inheritance = 2.0f * (combined - perimeter(node, node));
+
+        float firstCost = perimeter(first, m_nodes[leaf]) + inheritance;
+        if (!isLeaf(node.first)) {
+          firstCost -= perimeter(first, first);
+        }
+
+        float secondCost = perimeter(second, m_nodes[leaf]) + inheritance;
+        if (!isLeaf(node.second)) {
+          secondCost -= perimeter(second, second);
+        }
+
+        if (cost < firstCost && cost < secondCost) {
+          break;
+        }
+
+        sibling = (firstCost < secondCost ? node.first : node.second);
+      }
+
+      // Create a new parent for the sibling and the leaf.
+      const int oldParent = m_nodes[sibling].parent;
+      const int parent = allocateNode();
+
+      m_nodes[parent].parent = oldParent;
+      m_nodes[parent].first = sibling;
+      m_nodes[parent].second = leaf;
+      merge(parent, sibling, leaf);
+
+      if (oldParent == null) {
+        m_root = parent;
+      }
+      else if (m_nodes[oldParent].first == sibling) {
+        m_nodes[oldParent].first = parent;
+      }
+      else {
+        m_nodes[oldParent].second = parent;
+      }
+
+      m_nodes[sibling].parent = parent;
+      m_nodes[leaf].parent = parent;
+
+      refit(parent);
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::removeLeaf(int leaf) noexcept {
+      if (leaf == m_root) {
+        m_root = null;
+        return;
+      }
+
+      // The sibling of the leaf replaces their common parent.
+      const int parent = m_nodes[leaf].parent;
+      const int grandParent = m_nodes[parent].parent;
+      const int sibling = (m_nodes[parent].first == leaf ? m_nodes[parent].second : m_nodes[parent].first);
+
+      m_nodes[sibling].parent = grandParent;
+      m_nodes[leaf].parent = null;
+
+      if (grandParent == null) {
+        m_root = sibling;
+      }
+      else if (m_nodes[grandParent].first == parent) {
+        m_nodes[grandParent].first = sibling;
+      }
+      else {
+        m_nodes[grandParent].second = sibling;
+      }
+
+      releaseNode(parent);
+      refit(grandParent);
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::refit(int node) noexcept {
+      while (node != null) {
+        node = balance(node);
+        merge(node, m_nodes[node].first, m_nodes[node].second);
+
+        node = m_nodes[node].parent;
+      }
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    int
+    SpatialIndex<Item, Priority>::balance(int a) noexcept {
+      if (isLeaf(a) || m_nodes[a].height < 2) {
+        return a;
+      }
+
+      // Promote the highest child of `a` if it is too high compared to the
+      // other one: its highest child is kept and `a` takes the other one.
+      const int b = m_nodes[a].first;
+      const int c = m_nodes[a].second;
+      const int diff = m_nodes[c].height - m_nodes[b].height;
+
+      if (diff >= -1 && diff <= 1) {
+        return a;
+      }
+
+      const int up = (diff > 1 ? c : b);
+      const int kept = (diff > 1 ? b : c);
+
+      const int f = m_nodes[up].first;
+      const int g = m_nodes[up].second;
+      const int higher = (m_nodes[f].height > m_nodes[g].height ? f : g);
+      const int lower = (higher == f ? g : f);
+
+      // Swap `a` and `up`.
+      m_nodes[up].first = a;
+      m_nodes[up].second = higher;
+      m_nodes[up].parent = m_nodes[a].parent;
+      m_nodes[a].parent = up;
+
+      if (m_nodes[up].parent == null) {
+        m_root = up;
+      }
+      else if (m_nodes[m_nodes[up].parent].first == a) {
+        m_nodes[m_nodes[up].parent].first = up;
+      }
+      else {
+        m_nodes[m_nodes[up].parent].second = up;
+      }
+
+      // The lowest child of `up` replaces it as child of `a`.
+      m_nodes[a].first = kept;
+      m_nodes[a].second = lower;
+      m_nodes[lower].parent = a;
+
+      merge(a, kept, lower);
+      merge(up, a, higher);
+
+      return up;
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    void
+    SpatialIndex<Item, Priority>::merge(int node,
+                                        int lhs,
+                                        int rhs) noexcept
+    {
+      Node& n = m_nodes[node];
+      const Node& l = m_nodes[lhs];
+      const Node& r = m_nodes[rhs];
+
+      n.left = std::min(l.left, r.left);
+      n.right = std::max(l.right, r.right);
+      n.bottom = std::min(l.bottom, r.bottom);
+      n.top = std::max(l.top, r.top);
+      n.height = 1 + std::max(l.height, r.height);
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    bool
+    SpatialIndex<Item, Priority>::isLeaf(int node) const noexcept {
+      return m_nodes[node].first == null;
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    bool
+    SpatialIndex<Item, Priority>::contains(const Node& node,
+                                           const utils::Vector2f& pos) noexcept
+    {
+      return
+        pos.x() >= node.left && pos.x() <= node.right &&
+        pos.y() >= node.bottom && pos.y() <= node.top
+      ;
+    }
+
+    template <typename Item, typename Priority>
+    inline
+    float
+    SpatialIndex<Item, Priority>::perimeter(const Node& lhs,
+                                            const Node& rhs) noexcept
+    {
+      const float width = std::max(lhs.right, rhs.right) - std::min(lhs.left, rhs.left);
+      const float height = std::max(lhs.top, rhs.top) - std::min(lhs.bottom, rhs.bottom);
+
+      return 2.0f * (width + height);
+    }
+
+  }
+}
+
+#endif    /* SPATIAL_INDEX_HXX */
@@ -0,0 +1,131 @@
+
+# include "TexturePool.hh"
+
+namespace sdl {
+  namespace core {
+
+    TexturePool::TexturePool(engine::EngineShPtr engine,
+                             std::size_t capacity):
+      m_engine(engine),
+      m_capacity(capacity),
+      m_textures(),
+      m_buckets(),
+      m_bytes(0u),
+      m_hits(0u),
+      m_misses(0u),
+      m_evictions(0u),
+      m_locker()
+    {}
+
+    TexturePool::~TexturePool() {
+      clear();
+    }
+
+    utils::Uuid
+    TexturePool::acquire(const utils::Sizef& size,
+                         const engine::Palette::ColorRole& role)
+    {
+      const std::lock_guard guard(m_locker);
+
+      // Try to find a texture with the right key: we use the most recently
+      // released one as it is more likely to still be hot.
+      const Key key = makeKey(size, role);
+      Buckets::iterator bucket = m_buckets.find(key);
+
+      if (bucket != m_buckets.end() && !bucket->second.empty()) {
+        Textures::iterator entry = bucket->second.back();
+        bucket->second.pop_back();
+
+        const utils::Uuid uuid = entry->uuid;
+        m_bytes -= entry->bytes;
+        m_textures.erase(entry);
+
+        ++m_hits;
+        return uuid;
+      }
+
+      // No texture available, create a new one with the dimensions of the
+      // size class so that it can be reused for any size of the class.
+      ++m_misses;
+      return m_engine->createTexture(utils::Sizef(static_cast<float>(key.w), static_cast<float>(key.h)), role);
+    }
+
+    void
+    TexturePool::release(const utils::Uuid& uuid) {
+      if (!uuid.valid()) {
+        return;
+      }
+
+      const std::lock_guard guard(m_locker);
+
+      // If pooling is disabled, destroy the texture right away.
+      if (m_capacity == 0u) {
+        m_engine->destroyTexture(uuid);
+        return;
+      }
+
+      // Register the texture in the pool. The memory used by the texture
+      // is estimated assuming four bytes per pixel. Textures created by the
+      // pool already have the size of their class.
+      const utils::Sizef size = m_engine->queryTexture(uuid);
+      const Key key = makeKey(size, m_engine->getTextureRole(uuid));
+      const std::size_t bytes = static_cast<std::size_t>(std::max(key.w, 0)) * static_cast<std::size_t>(std::max(key.h, 0)) * 4u;
+
+      m_textures.push_back(Entry{uuid, key, bytes});
+      m_buckets[key].push_back(std::prev(m_textures.end()));
+      m_bytes += bytes;
+
+      // Make sure we stay below the capacity.
+      trim(m_capacity);
+    }
+
+    void
+    TexturePool::clear() {
+      const std::lock_guard guard(m_locker);
+
+      for (Textures::const_iterator entry = m_textures.cbegin() ; entry != m_textures.cend() ; ++entry) {
+        m_engine->destroyTexture(entry->uuid);
+      }
+
+      m_textures.clear();
+      m_buckets.clear();
+      m_bytes = 0u;
+    }
+
+    void
+    TexturePool::setCapacity(std::size_t capacity) {
+      const std::lock_guard guard(m_locker);
+
+      m_capacity = capacity;
+      trim(m_capacity);
+    }
+
+    void
+    TexturePool::trim(std::size_t bytes) {
+      // Destroy the least recently released textures until we reach the
+      // desired amount of memory.
+      while (m_bytes > bytes && !m_textures.empty()) {
+        Textures::iterator entry = m_textures.begin();
+
+        // Remove the texture from its bucket: it is necessarily the first
+        // one as textures are added to the buckets by order of release.
+        Buckets::iterator bucket = m_buckets.find(entry->key);
+        if (bucket != m_buckets.end()) {
+          bucket->second.erase(bucket->second.begin());
+
+          if (bucket->second.empty()) {
+            m_buckets.erase(bucket);
+          }
+        }
+
+        m_engine->destroyTexture(entry->uuid);
+
+        m_bytes -= entry->bytes;
+        m_textures.erase(entry);
+
+        ++m_evictions;
+      }
+    }
+
+  }
+}
@@ -0,0 +1,239 @@
+#ifndef    TEXTURE_POOL_HH
+# define   TEXTURE_POOL_HH
+
+# include <map>
+# include <list>
+# include <mutex>
+# include <memory>
+# include <vector>
+# include <maths_utils/Size.hh>
+# include <core_utils/Uuid.hh>
+# include <sdl_engine/Engine.hh>
+# include <sdl_engine/Palette.hh>
+
+namespace sdl {
+  namespace core {
+
+    class TexturePool {
+      public:
+
+        /**
+         * @brief - Creates a texture pool using the specified engine to create and
+         *          destroy textures. The pool keeps textures released by widgets so
+         *          that they can be reused later on instead of going through a full
+         *          destroy and create round trip with the engine.
+         * @param engine - the engine to use to create and destroy textures.
+         * @param capacity - the maximum amount of memory (in bytes) which can be used
+         *                   by the textures kept in the pool.
+         */
+        TexturePool(engine::EngineShPtr engine,
+                    std::size_t capacity = 64u * 1024u * 1024u);
+
+        /**
+         * @brief - Destroys all the textures kept in the pool.
+         */
+        ~TexturePool();
+
+        /**
+         * @brief - Retrieves a texture with at least the specified size and the input
+         *          role. The size is rounded up to a coarse size class (see `makeKey`)
+         *          so that widgets with slightly different sizes can share textures:
+         *          a texture is taken from the pool if one is available with the same
+         *          size class and role, otherwise a new one is created with the size of
+         *          the class using the engine.
+         *          The caller should only use the top left part of the texture matching
+         *          the requested size. Note that the content of a texture taken from the
+         *          pool is undefined and should be cleared by the caller.
+         * @param size - the minimum size of the texture to retrieve.
+         * @param role - the color role of the texture to retrieve.
+         * @return - an identifier of a texture with the specified size and role.
+         */
+        utils::Uuid
+        acquire(const utils::Sizef& size,
+                const engine::Palette::ColorRole& role);
+
+        /**
+         * @brief - Returns the texture to the pool so that it can be reused. If the pool
+         *          exceeds its capacity once the texture is added, the least recently
+         *          released textures are destroyed. Invalid identifiers are ignored.
+         * @param uuid - the identifier of the texture to release.
+         */
+        void
+        release(const utils::Uuid& uuid);
+
+        /**
+         * @brief - Destroys all the textures kept in the pool.
+         */
+        void
+        clear();
+
+        /**
+         * @brief - Retrieves the maximum amount of memory which can be used by the
+         *          textures kept in the pool.
+         * @return - the capacity of the pool in bytes.
+         */
+        std::size_t
+        getCapacity() const noexcept;
+
+        /**
+         * @brief - Assigns a new capacity for this pool. Textures are destroyed if the
+         *          current memory used by the pool exceeds the new capacity. A capacity
+         *          of `0` disables the pooling entirely.
+         * @param capacity - the new capacity of the pool in bytes.
+         */
+        void
+        setCapacity(std::size_t capacity);
+
+        /**
+         * @brief - Returns the number of textures which could be retrieved from the pool
+         *          since its creation.
+         * @return - the number of hits of the pool.
+         */
+        unsigned
+        getHits() const noexcept;
+
+        /**
+         * @brief - Returns the number of textures which had to be created because no
+         *          suitable one could be found in the pool.
+         * @return - the number of misses of the pool.
+         */
+        unsigned
+        getMisses() const noexcept;
+
+        /**
+         * @brief - Returns the number of textures which were destroyed to keep the memory
+         *          used by the pool below its capacity.
+         * @return - the number of evictions performed by the pool.
+         */
+        unsigned
+        getEvictions() const noexcept;
+
+        /**
+         * @brief - Returns the estimated amount of memory used by the textures currently
+         *          kept in the pool.
+         * @return - the memory used by the pool in bytes.
+         */
+        std::size_t
+        getBytes() const noexcept;
+
+        /**
+         * @brief - Returns the number of textures currently kept in the pool.
+         * @return - the number of textures available for reuse.
+         */
+        unsigned
+        getTexturesCount() const noexcept;
+
+      private:
+
+        /**
+         * @brief - Describes the bucket of a texture: textures with the same size class
+         *          and the same color role are interchangeable.
+         */
+        struct Key {
+          int w;
+          int h;
+          engine::Palette::ColorRole role;
+
+          bool
+          operator<(const Key& rhs) const noexcept;
+        };
+
+        /**
+         * @brief - Describes a texture kept in the pool.
+         */
+        struct Entry {
+          utils::Uuid uuid;
+          Key key;
+          std::size_t bytes;
+        };
+
+        /**
+         * @brief - Convenience define to refer to the list of textures kept in the pool
+         *          sorted from the least recently released to the most recently released.
+         */
+        using Textures = std::list<Entry>;
+
+        /**
+         * @brief - Convenience define to refer to the textures available for each key.
+         */
+        using Buckets = std::map<Key, std::vector<Textures::iterator>>;
+
+        /**
+         * @brief - Builds the key corresponding to the input size and role. Each dimension
+         *          is rounded up to the next power of two up to `SizeClassStep` pixels
+         *          and to the next multiple of this step above it: this keeps the number
+         *          of buckets low while wasting at most a step worth of pixels on large
+         *          textures.
+         * @param size - the size of the texture.
+         * @param role - the role of the texture.
+         * @return - the key of the texture.
+         */
+        static
+        Key
+        makeKey(const utils::Sizef& size,
+                const engine::Palette::ColorRole& role) noexcept;
+
+        /**
+         * @brief - Rounds up the input dimension to its size class as described in the
+         *          `makeKey` method.
+         * @param dim - the dimension to round.
+         * @return - the dimension of the size class.
+         */
+        static
+        int
+        roundToSizeClass(float dim) noexcept;
+
+        /**
+         * @brief - The granularity of the size classes for large textures.
+         */
+        static constexpr int SizeClassStep = 64;
+
+        /**
+         * @brief - Destroys the least recently released textures until the memory used
+         *          by the pool is below the specified amount.
+         *          Assumes that the `m_locker` is already acquired.
+         * @param bytes - the maximum amount of memory to keep in the pool.
+         */
+        void
+        trim(std::size_t bytes);
+
+      private:
+
+        /**
+         * @brief - The engine used to create and destroy textures.
+         */
+        engine::EngineShPtr m_engine;
+
+        /**
+         * @brief - The maximum amount of memory which can be used by the pool.
+         */
+        std::size_t m_capacity;
+
+        /**
+         * @brief - The textures kept in the pool by order of release and indexed by
+         *          their key.
+         */
+        Textures m_textures;
+        Buckets m_buckets;
+
+        /**
+         * @brief - Statistics about the pool.
+         */
+        std::size_t m_bytes;
+        unsigned m_hits;
+        unsigned m_misses;
+        unsigned m_evictions;
+
+        /**
+         * @brief - Used to protect the pool from concurrent accesses.
+         */
+        mutable std::mutex m_locker;
+    };
+
+    using TexturePoolShPtr = std::shared_ptr<TexturePool>;
+  }
+}
+
+# include "TexturePool.hxx"
+
+#endif    /* TEXTURE_POOL_HH */
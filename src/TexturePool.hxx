@@ -0,0 +1,101 @@
+#ifndef    TEXTURE_POOL_HXX
+# define   TEXTURE_POOL_HXX
+
+# include "TexturePool.hh"
+# include <cmath>
+
+namespace sdl {
+  namespace core {
+
+    inline
+    bool
+    TexturePool::Key::operator<(const Key& rhs) const noexcept {
+      if (w != rhs.w) {
+        return w < rhs.w;
+      }
+
+      if (h != rhs.h) {
+        return h < rhs.h;
+      }
+
+      return role < rhs.role;
+    }
+
+    inline
+    std::size_t
+    TexturePool::getCapacity() const noexcept {
+      const std::lock_guard guard(m_locker);
+      return m_capacity;
+    }
+
+    inline
+    unsigned
+    TexturePool::getHits() const noexcept {
+      const std::lock_guard guard(m_locker);
+      return m_hits;
+    }
+
+    inline
+    unsigned
+    TexturePool::getMisses() const noexcept {
+      const std::lock_guard guard(m_locker);
+      return m_misses;
+    }
+
+    inline
+    unsigned
+    TexturePool::getEvictions() const noexcept {
+      const std::lock_guard guard(m_locker);
+      return m_evictions;
+    }
+
+    inline
+    std::size_t
+    TexturePool::getBytes() const noexcept {
+      const std::lock_guard guard(m_locker);
+      return m_bytes;
+    }
+
+    inline
+    unsigned
+    TexturePool::getTexturesCount() const noexcept {
+      const std::lock_guard guard(m_locker);
+      return m_textures.size();
+    }
+
+    inline
+    TexturePool::Key
+    TexturePool::makeKey(const utils::Sizef& size,
+                         const engine::Palette::ColorRole& role) noexcept
+    {
+      return Key{
+        roundToSizeClass(size.w()),
+        roundToSizeClass(size.h()),
+        role
+      };
+    }
+
+    inline
+    int
+    TexturePool::roundToSizeClass(float dim) noexcept {
+      const int pixels = static_cast<int>(std::ceil(dim));
+      if (pixels <= 1) {
+        return 1;
+      }
+
+      if (pixels > SizeClassStep) {
+        return (pixels + SizeClassStep - 1) / SizeClassStep * SizeClassStep;
+      }
+
+      int rounded = 1;
+      while (rounded < pixels) {
+        rounded *= 2;
+      }
+
+      return rounded;
+    }
+
+  }
+}
+
+#endif    /* TEXTURE_POOL_HXX */
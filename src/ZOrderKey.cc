@@ -0,0 +1,25 @@
+
+# include "ZOrderKey.hh"
+
+namespace sdl {
+  namespace core {
+
+    std::string
+    ZOrderKey::toString() const {
+      std::string out("[");
+
+      for (unsigned id = 0u ; id < m_depth ; ++id) {
+        if (id > 0u) {
+          out += ", ";
+        }
+
+        out += std::to_string(m_levels[id]);
+      }
+
+      out += "]";
+
+      return out;
+    }
+
+  }
+}
@@ -0,0 +1,101 @@
+#ifndef    Z_ORDER_KEY_HH
+# define   Z_ORDER_KEY_HH
+
+# include <array>
+# include <string>
+
+namespace sdl {
+  namespace core {
+
+    class ZOrderKey {
+      public:
+
+        /**
+         * @brief - The maximum number of levels of the hierarchy which can be described
+         *          by a key. Levels deeper than this value are ignored when building a
+         *          key which means that the ordering of items nested deeper than that
+         *          is only determined by their ancestors.
+         */
+        static constexpr unsigned MaxDepth = 16u;
+
+        /**
+         * @brief - Creates an empty key which does not describe any level. An empty key
+         *          is less than any other key.
+         */
+        ZOrderKey() noexcept;
+
+        /**
+         * @brief - Creates a key describing a single level with the specified `z` order.
+         *          This typically represents the key of a root item.
+         * @param order - the `z` order of the item.
+         */
+        explicit
+        ZOrderKey(int order) noexcept;
+
+        /**
+         * @brief - Creates a key by appending the input `z` order to the `parent` key.
+         *          This typically represents the key of a child of the item represented
+         *          by the `parent` key.
+         * @param parent - the key of the parent item.
+         * @param order - the `z` order of the item.
+         */
+        ZOrderKey(const ZOrderKey& parent,
+                  int order) noexcept;
+
+        ~ZOrderKey() = default;
+
+        /**
+         * @brief - Returns the number of levels described by this key.
+         * @return - the depth of this key.
+         */
+        unsigned
+        getDepth() const noexcept;
+
+        /**
+         * @brief - Compares `this` key with the `rhs` key. Keys are compared level by
+         *          level starting from the top most ancestor: the first level where both
+         *          keys differ determines the ordering. If all the levels of the shortest
+         *          key are equal to the corresponding levels of the other one, the shortest
+         *          key is less than the other one.
+         *          Unlike the string representation, this handles correctly negative and
+         *          multi-digit `z` orders.
+         * @param rhs - the key to compare with `this`.
+         * @return - `true` if `this` key is less than `rhs`.
+         */
+        bool
+        operator<(const ZOrderKey& rhs) const noexcept;
+
+        bool
+        operator==(const ZOrderKey& rhs) const noexcept;
+
+        bool
+        operator!=(const ZOrderKey& rhs) const noexcept;
+
+        /**
+         * @brief - Produces a string representation of this key. Only meant to be used
+         *          for debugging purposes.
+         * @return - a string describing the levels of this key.
+         */
+        std::string
+        toString() const;
+
+      private:
+
+        /**
+         * @brief - The `z` order of each level of the key starting from the top most
+         *          ancestor. Only the first `m_depth` values are meaningful.
+         */
+        std::array<int, MaxDepth> m_levels;
+
+        /**
+         * @brief - The number of levels described by this key.
+         */
+        unsigned m_depth;
+    };
+
+  }
+}
+
+# include "ZOrderKey.hxx"
+
+#endif    /* Z_ORDER_KEY_HH */
@@ -0,0 +1,81 @@
+#ifndef    Z_ORDER_KEY_HXX
+# define   Z_ORDER_KEY_HXX
+
+# include "ZOrderKey.hh"
+
+namespace sdl {
+  namespace core {
+
+    inline
+    ZOrderKey::ZOrderKey() noexcept:
+      m_levels(),
+      m_depth(0u)
+    {}
+
+    inline
+    ZOrderKey::ZOrderKey(int order) noexcept:
+      m_levels(),
+      m_depth(1u)
+    {
+      m_levels[0u] = order;
+    }
+
+    inline
+    ZOrderKey::ZOrderKey(const ZOrderKey& parent,
+                         int order) noexcept:
+      m_levels(parent.m_levels),
+      m_depth(parent.m_depth)
+    {
+      // Levels deeper than the maximum depth are ignored.
+      if (m_depth < MaxDepth) {
+        m_levels[m_depth] = order;
+        ++m_depth;
+      }
+    }
+
+    inline
+    unsigned
+    ZOrderKey::getDepth() const noexcept {
+      return m_depth;
+    }
+
+    inline
+    bool
+    ZOrderKey::operator<(const ZOrderKey& rhs) const noexcept {
+      const unsigned depth = (m_depth < rhs.m_depth ? m_depth : rhs.m_depth);
+
+      for (unsigned id = 0u ; id < depth ; ++id) {
+        if (m_levels[id] != rhs.m_levels[id]) {
+          return m_levels[id] < rhs.m_levels[id];
+        }
+      }
+
+      return m_depth < rhs.m_depth;
+    }
+
+    inline
+    bool
+    ZOrderKey::operator==(const ZOrderKey& rhs) const noexcept {
+      if (m_depth != rhs.m_depth) {
+        return false;
+      }
+
+      for (unsigned id = 0u ; id < m_depth ; ++id) {
+        if (m_levels[id] != rhs.m_levels[id]) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    inline
+    bool
+    ZOrderKey::operator!=(const ZOrderKey& rhs) const noexcept {
+      return !operator==(rhs);
+    }
+
+  }
+}
+
+#endif    /* Z_ORDER_KEY_HXX */
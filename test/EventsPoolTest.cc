@@ -0,0 +1,116 @@
+
+# include <cassert>
+# include <thread>
+# include <vector>
+# include <iostream>
+# include "EventsPool.hh"
+
+namespace {
+
+  using sdl::core::EventsPool;
+
+  /**
+   * @brief - Mimics the layout of an event: a polymorphic object with a few
+   *          members.
+   */
+  class Dummy {
+    public:
+
+      explicit
+      Dummy(int value):
+        m_value(value),
+        m_area{0.0f, 0.0f, 0.0f, 0.0f}
+      {}
+
+      virtual ~Dummy() = default;
+
+      int
+      getValue() const noexcept {
+        return m_value;
+      }
+
+    private:
+
+      int m_value;
+      float m_area[4];
+  };
+
+  void
+  testCounters() {
+    const unsigned live = EventsPool::getLiveCount();
+
+    std::vector<std::shared_ptr<Dummy>> events;
+    for (int id = 0 ; id < 10 ; ++id) {
+      events.push_back(EventsPool::create<Dummy>(id));
+      assert(events.back()->getValue() == id);
+    }
+
+    assert(EventsPool::getLiveCount() == live + 10u);
+    assert(EventsPool::getPeakCount() >= live + 10u);
+
+    // Released blocks are kept for the next events.
+    const unsigned pooled = EventsPool::getPooledCount();
+    events.clear();
+
+    assert(EventsPool::getLiveCount() == live);
+    assert(EventsPool::getPooledCount() == pooled + 10u);
+
+    std::shared_ptr<Dummy> e = EventsPool::create<Dummy>(42);
+    assert(EventsPool::getPooledCount() == pooled + 9u);
+    assert(e->getValue() == 42);
+  }
+
+  void
+  testCapacity() {
+    EventsPool::setCapacity(2u);
+
+    std::vector<std::shared_ptr<Dummy>> events;
+    for (int id = 0 ; id < 10 ; ++id) {
+      events.push_back(EventsPool::create<Dummy>(id));
+    }
+
+    events.clear();
+    assert(EventsPool::getPooledCount() <= 2u);
+
+    EventsPool::setCapacity(256u);
+  }
+
+  void
+  testThreads() {
+    const unsigned live = EventsPool::getLiveCount();
+
+    // Events created on a thread and released on another one.
+    std::vector<std::shared_ptr<Dummy>> events;
+    std::thread producer(
+      [&events]() {
+        for (int id = 0 ; id < 100 ; ++id) {
+          events.push_back(EventsPool::create<Dummy>(id));
+        }
+      }
+    );
+    producer.join();
+
+    assert(EventsPool::getLiveCount() == live + 100u);
+
+    std::thread consumer(
+      [&events]() {
+        events.clear();
+      }
+    );
+    consumer.join();
+
+    assert(EventsPool::getLiveCount() == live);
+  }
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/) {
+  testCounters();
+  testCapacity();
+  testThreads();
+
+  std::cout << "[POOL] All tests passed (peak: " << EventsPool::getPeakCount() << ")" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+
+# include <cassert>
+# include <random>
+# include <vector>
+# include <iostream>
+# include "LayoutKernels.hh"
+
+namespace {
+
+  using namespace sdl::core::layout;
+
+  /**
+   * @brief - Generates the description of `count` items along an axis with random
+   *          sizes and constraints. Some of the current sizes are set to one of the
+   *          bounds so that the comparisons are exercised on equality too.
+   */
+  AxisInfo
+  randomAxis(std::mt19937& rng,
+             unsigned count)
+  {
+    std::uniform_real_distribution<float> size(0.0f, 200.0f);
+    AxisInfo axis;
+
+    for (unsigned id = 0u ; id < count ; ++id) {
+      const float min = size(rng) * 0.5f;
+      const float max = min + size(rng);
+      const float hint = min + (max - min) * (size(rng) / 200.0f);
+
+      float current = size(rng);
+      switch (rng() % 4u) {
+        case 0u:
+          current = min;
+          break;
+        case 1u:
+          current = hint;
+          break;
+        default:
+          break;
+      }
+
+      axis.current.push_back(current);
+      axis.min.push_back(min);
+      axis.hint.push_back(hint);
+      axis.max.push_back(max);
+      axis.flags.push_back(rng() % 16u);
+    }
+
+    return axis;
+  }
+
+  void
+  testRules() {
+    // Fixed items use their hint whatever the delta, unless it is not valid.
+    assert(clamp(10.0f, 50.0f, 0.0f, 20.0f, 100.0f, toConstraints(true, true, true, true)) == 20.0f);
+    assert(clamp(10.0f, 50.0f, 0.0f, 20.0f, 100.0f, toConstraints(false, true, true, true)) == 60.0f);
+
+    // Sizes are clamped to the bounds.
+    assert(clamp(10.0f, 500.0f, 0.0f, 20.0f, 100.0f, toConstraints(false, false, true, true)) == 100.0f);
+    assert(clamp(10.0f, -50.0f, 5.0f, 20.0f, 100.0f, toConstraints(false, false, true, true)) == 5.0f);
+
+    // The hint replaces the bounds for items which can't shrink or extend.
+    assert(clamp(10.0f, 50.0f, 0.0f, 20.0f, 100.0f, toConstraints(true, false, true, false)) == 20.0f);
+    assert(clamp(30.0f, -20.0f, 0.0f, 20.0f, 100.0f, toConstraints(true, false, false, true)) == 20.0f);
+
+    assert(isUsable(20.0f, 0.0f, 20.0f, 100.0f, toConstraints(true, false, false, true), Constraint::Shrink) == false);
+    assert(isUsable(20.0f, 0.0f, 20.0f, 100.0f, toConstraints(true, false, true, true), Constraint::Shrink) == true);
+    assert(isUsable(20.0f, 0.0f, 20.0f, 100.0f, toConstraints(true, false, true, false), Constraint::Extend) == false);
+    assert(isUsable(20.0f, 0.0f, 20.0f, 100.0f, toConstraints(false, false, true, false), Constraint::Extend) == true);
+    assert(isUsable(20.0f, 0.0f, 20.0f, 100.0f, toConstraints(false, false, true, true), 0u) == false);
+
+    assert(resolveAction(100.0f, 100.5f, 1.0f) == 0u);
+    assert(resolveAction(100.0f, 120.0f, 1.0f) == Constraint::Shrink);
+    assert(resolveAction(100.0f, 80.0f, 1.0f) == Constraint::Extend);
+  }
+
+  void
+  testClampAxis(std::mt19937& rng) {
+    std::uniform_real_distribution<float> delta(-150.0f, 150.0f);
+
+    // Use counts which are not a multiple of the width of the kernels so
+    // that the remainder is processed as well.
+    for (unsigned count = 0u ; count < 67u ; ++count) {
+      const AxisInfo axis = randomAxis(rng, count);
+
+      std::vector<float> deltas(count);
+      for (unsigned id = 0u ; id < count ; ++id) {
+        deltas[id] = delta(rng);
+      }
+
+      std::vector<float> out(count);
+      clampAxis(axis, deltas.data(), out.data());
+
+      for (unsigned id = 0u ; id < count ; ++id) {
+        assert(out[id] == clamp(axis.current[id], deltas[id], axis.min[id], axis.hint[id], axis.max[id], axis.flags[id]));
+      }
+
+      // The output can be the input deltas.
+      clampAxis(axis, deltas.data(), deltas.data());
+      assert(deltas == out);
+    }
+  }
+
+  void
+  testUsableAxis(std::mt19937& rng) {
+    for (unsigned count = 0u ; count < 67u ; ++count) {
+      const AxisInfo axis = randomAxis(rng, count);
+      std::vector<std::uint8_t> out(count);
+
+      for (std::uint32_t action = 0u ; action < 16u ; action += Constraint::Shrink) {
+        usableAxis(axis, action, out.data());
+
+        for (unsigned id = 0u ; id < count ; ++id) {
+          assert((out[id] != 0u) == isUsable(axis.current[id], axis.min[id], axis.hint[id], axis.max[id], axis.flags[id], action));
+        }
+      }
+    }
+  }
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/) {
+  std::mt19937 rng(42u);
+
+  testRules();
+  testClampAxis(rng);
+  testUsableAxis(rng);
+
+  std::cout << "[TEST] Layout kernels (" << getKernelsName() << "): OK" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,226 @@
+
+# include <cassert>
+# include <random>
+# include <vector>
+# include <iostream>
+# include "SoftwareKernels.hh"
+
+namespace {
+
+  using sdl::core::software::Pixel;
+  using sdl::core::software::Rect;
+  using sdl::core::software::Surface;
+
+  /**
+   * @brief - Reference implementation of the blending of a single pixel.
+   */
+  Pixel
+  blendPixel(Pixel d,
+             Pixel s)
+  {
+    const unsigned alpha = s >> 24u;
+    Pixel out = 0u;
+
+    for (unsigned channel = 0u ; channel < 4u ; ++channel) {
+      const unsigned shift = channel * 8u;
+      const unsigned sc = (s >> shift) & 0xFFu;
+      const unsigned dc = (d >> shift) & 0xFFu;
+      const unsigned factor = (channel == 3u ? 255u : alpha);
+
+      const unsigned v = sc * factor + dc * (255u - alpha);
+      out |= ((v + 127u) / 255u) << shift;
+    }
+
+    return out;
+  }
+
+  /**
+   * @brief - Reference implementation of the blit: each pixel of the clipped
+   *          destination is mapped to the nearest pixel of the source.
+   */
+  void
+  blitReference(const Surface& source,
+                const Rect& from,
+                const Surface& target,
+                const Rect& where)
+  {
+    if (from.w <= 0 || from.h <= 0 || where.w <= 0 || where.h <= 0) {
+      return;
+    }
+
+    for (int row = std::max(where.y, 0) ; row < std::min(where.y + where.h, target.h) ; ++row) {
+      const int srcRow = from.y + static_cast<int>((static_cast<long>(row - where.y) * from.h) / where.h);
+
+      for (int col = std::max(where.x, 0) ; col < std::min(where.x + where.w, target.w) ; ++col) {
+        const int srcCol = from.x + static_cast<int>((static_cast<long>(col - where.x) * from.w) / where.w);
+
+        if (srcRow < 0 || srcRow >= source.h || srcCol < 0 || srcCol >= source.w) {
+          continue;
+        }
+
+        Pixel& d = target.pixels[row * target.w + col];
+        d = blendPixel(d, source.pixels[srcRow * source.w + srcCol]);
+      }
+    }
+  }
+
+  /**
+   * @brief - Generates random pixels, with a fair share of fully opaque and of
+   *          fully transparent ones.
+   */
+  std::vector<Pixel>
+  randomPixels(std::mt19937& rng,
+               std::size_t count)
+  {
+    std::vector<Pixel> out(count);
+
+    for (std::size_t id = 0u ; id < count ; ++id) {
+      Pixel p = rng();
+      switch (rng() % 4u) {
+        case 0u:
+          p |= 0xFF000000u;
+          break;
+        case 1u:
+          p &= 0x00FFFFFFu;
+          break;
+        default:
+          break;
+      }
+
+      out[id] = p;
+    }
+
+    return out;
+  }
+
+  Rect
+  randomRect(std::mt19937& rng,
+             int w,
+             int h)
+  {
+    return Rect{
+      static_cast<int>(rng() % (w + 8)) - 4,
+      static_cast<int>(rng() % (h + 8)) - 4,
+      static_cast<int>(rng() % (w + 4)),
+      static_cast<int>(rng() % (h + 4))
+    };
+  }
+
+  void
+  testBlend(std::mt19937& rng) {
+    // Cover the vectorized loops along with their scalar tails.
+    for (unsigned count = 0u ; count < 70u ; ++count) {
+      const std::vector<Pixel> src = randomPixels(rng, count);
+      std::vector<Pixel> dst = randomPixels(rng, count);
+      std::vector<Pixel> expected = dst;
+
+      for (unsigned id = 0u ; id < count ; ++id) {
+        expected[id] = blendPixel(expected[id], src[id]);
+      }
+
+      sdl::core::software::blend(dst.data(), src.data(), count);
+      assert(dst == expected);
+    }
+  }
+
+  void
+  testFill(std::mt19937& rng) {
+    const int w = 37;
+    const int h = 21;
+
+    for (unsigned iteration = 0u ; iteration < 200u ; ++iteration) {
+      std::vector<Pixel> pixels = randomPixels(rng, w * h);
+      std::vector<Pixel> expected = pixels;
+
+      const Rect area = randomRect(rng, w, h);
+      const Pixel color = rng();
+
+      for (int row = std::max(area.y, 0) ; row < std::min(area.y + area.h, h) ; ++row) {
+        for (int col = std::max(area.x, 0) ; col < std::min(area.x + area.w, w) ; ++col) {
+          expected[row * w + col] = color;
+        }
+      }
+
+      sdl::core::software::fill(Surface{pixels.data(), w, h}, area, color);
+      assert(pixels == expected);
+    }
+  }
+
+  void
+  testBlit(std::mt19937& rng) {
+    const int sw = 29;
+    const int sh = 17;
+    const int tw = 41;
+    const int th = 23;
+
+    std::vector<Pixel> scratch;
+
+    for (unsigned iteration = 0u ; iteration < 500u ; ++iteration) {
+      std::vector<Pixel> source = randomPixels(rng, sw * sh);
+      std::vector<Pixel> target = randomPixels(rng, tw * th);
+      std::vector<Pixel> expected = target;
+
+      const Rect from = randomRect(rng, sw, sh);
+      // Use the same dimensions half of the time to cover the direct path.
+      Rect where = randomRect(rng, tw, th);
+      if (iteration % 2u == 0u) {
+        where.w = from.w;
+        where.h = from.h;
+      }
+
+      blitReference(Surface{source.data(), sw, sh}, from, Surface{expected.data(), tw, th}, where);
+      sdl::core::software::blit(Surface{source.data(), sw, sh}, from, Surface{target.data(), tw, th}, where, scratch);
+
+      assert(target == expected);
+    }
+  }
+
+  void
+  testOverlappingBlit(std::mt19937& rng) {
+    const int w = 33;
+    const int h = 19;
+
+    std::vector<Pixel> scratch;
+
+    for (unsigned iteration = 0u ; iteration < 500u ; ++iteration) {
+      std::vector<Pixel> pixels = randomPixels(rng, w * h);
+
+      // Shift an area by a few pixels in any direction so that the source
+      // and the destination overlap: the result should be the same as when
+      // reading from an untouched copy of the texture.
+      const Rect from = randomRect(rng, w, h);
+      Rect where = from;
+      where.x += static_cast<int>(rng() % 7u) - 3;
+      where.y += static_cast<int>(rng() % 7u) - 3;
+      if (iteration % 2u == 1u) {
+        where.w += static_cast<int>(rng() % 5u);
+        where.h += static_cast<int>(rng() % 5u);
+      }
+
+      const std::vector<Pixel> copy = pixels;
+      std::vector<Pixel> expected = pixels;
+
+      blitReference(Surface{const_cast<Pixel*>(copy.data()), w, h}, from, Surface{expected.data(), w, h}, where);
+      sdl::core::software::blit(Surface{pixels.data(), w, h}, from, Surface{pixels.data(), w, h}, where, scratch);
+
+      assert(pixels == expected);
+    }
+  }
+
+}
+
+int
+main(int /*argc*/, char** /*argv*/) {
+  std::mt19937 rng(42u);
+
+  std::cout << "[KERNELS] Testing " << sdl::core::software::getKernelsName() << " kernels" << std::endl;
+
+  testBlend(rng);
+  testFill(rng);
+  testBlit(rng);
+  testOverlappingBlit(rng);
+
+  std::cout << "[KERNELS] All tests passed" << std::endl;
+
+  return 0;
+}